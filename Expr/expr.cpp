@@ -85,7 +85,8 @@ public:
 
 template<typename CInt>
 std::pair<Mono, CInt> gcd(std::pair<Mono, CInt> const& a, std::pair<Mono, CInt> const& b) {
-    return {gcd(a.first, b.first), std::gcd(a.second, b.second)};
+    using std::gcd;
+    return {gcd(a.first, b.first), gcd(a.second, b.second)};
 }
 
 template<typename CInt>
@@ -132,7 +133,7 @@ public:
 	}
 	
 	IntExpr operator-() const {
-		return *this * -1;
+		return *this * IntExpr(CInt(-1));
 	}
 	
 	IntExpr& operator+=(IntExpr const& other) {
@@ -215,7 +216,7 @@ public:
         for (auto const& [x, k] : core) {
             if (x.contains(name)) {
                 mono x0 = x;
-                CInt n = x0.at(name);
+                size_t n = x0.at(name);
                 x0.erase(name);
                 ans += IntExpr({x0, k}) * pow(expr, n);
             } else {
@@ -226,15 +227,16 @@ public:
 	}
 
     IntExpr eval(std::pair<Mono, size_t> const& m, IntExpr const& expr) const {
+        std::pair<Mono, CInt> const mc{m.first, CInt(m.second)};
         IntExpr ans;
         for (auto const& [x, k] : core) {
-            if (yao_math::gcd({x, k}, m) == m) {
+            if (yao_math::gcd({x, k}, mc) == mc) {
                 mono x0 = x;
-                size_t k0 = k;
+                CInt k0 = k;
                 size_t n = 0;
-                while (yao_math::gcd({x0, k0}, m) == m) {
-                    x0.div(m.first);
-                    k0 /= m.second;
+                while (yao_math::gcd({x0, k0}, mc) == mc) {
+                    x0.div(mc.first);
+                    k0 /= mc.second;
                     ++n;
                 }
                 ans += IntExpr({x0, k0}) * pow(expr, n);
@@ -250,7 +252,7 @@ public:
         for (auto const& [x, k] : core) {
             if (x.contains(name)) {
                 mono x0 = x;
-                CInt n = x0.at(name);
+                size_t n = x0.at(name);
                 x0.erase(name);
                 ans += IntExpr({x0, k}) * pow(expr, n);
             } else {
@@ -261,15 +263,16 @@ public:
 	}
 
     RatioExpr<CInt> eval(std::pair<Mono, size_t> const& m, RatioExpr<CInt> const& expr) const {
+        std::pair<Mono, CInt> const mc{m.first, CInt(m.second)};
         RatioExpr<CInt> ans;
         for (auto const& [x, k] : core) {
-            if (yao_math::gcd({x, k}, m) == m) {
+            if (yao_math::gcd({x, k}, mc) == mc) {
                 mono x0 = x;
-                size_t k0 = k;
+                CInt k0 = k;
                 size_t n = 0;
-                while (yao_math::gcd({x0, k0}, m) == m) {
-                    x0.div(m.first);
-                    k0 /= m.second;
+                while (yao_math::gcd({x0, k0}, mc) == mc) {
+                    x0.div(mc.first);
+                    k0 /= mc.second;
                     ++n;
                 }
                 ans += IntExpr({x0, k0}) * pow(expr, n);
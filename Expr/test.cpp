@@ -2,6 +2,7 @@
 using namespace std;
 
 #include "expr.cpp"
+#include "../Int/big_int.cpp"
 
 using namespace yao_math;
 
@@ -33,8 +34,19 @@ void substitute() {
     cout << toTex(e2) << endl;
 }
 
+void big_coefficients() {
+    // the middle coefficients of (x+1)^70 overflow 64 bits
+    IntExpr<big_int> x("x", 1);
+    IntExpr e1 = pow(x + big_int(1), 70);
+    cout << toTex(e1) << endl;
+    cout << toTex(e1.eval("x", big_int(-1))) << endl;
+    IntExpr e2 = e1.eval({{{{"x", 2}}}, 1}, IntExpr<big_int>(big_int(1)));
+    cout << toTex(e2) << endl;
+}
+
 int main() {
     int_expr();
     ratio_expr();
     substitute();
+    big_coefficients();
 }
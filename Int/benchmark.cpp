@@ -0,0 +1,15 @@
+#ifndef YAO_MATH_BENCHMARK
+#define YAO_MATH_BENCHMARK
+
+// keeps the optimizer from discarding the value computed by the benchmark
+template<typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+#endif
@@ -0,0 +1,655 @@
+#include <cstdint>
+#include <cstddef>
+#include <compare>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <iostream>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+
+#include "wide_int.cpp"
+
+#ifndef YAO_MATH_BIG_INT
+#define YAO_MATH_BIG_INT
+
+namespace yao_math {
+
+/*
+ * an integer of any width in sign-magnitude, whose limbs grow as needed
+ *
+ * numbers up to INLINE_LIMBS limbs live inside the object, larger ones are
+ * taken from the allocator, which may be an arena through std::pmr; the
+ * arithmetic runs on the same limb kernels as wide_int, and the division
+ * truncates towards zero as the built-in integers do
+ */
+template<typename Allocator = std::allocator<std::uint64_t>>
+class basic_big_int {
+public:
+    using limb_type = std::uint64_t;
+    using allocator_type = Allocator;
+    constexpr static size_t LIMB_BITS = limb::bits<limb_type>;
+    constexpr static size_t INLINE_LIMBS = 4;
+
+private:
+    using traits = std::allocator_traits<Allocator>;
+
+    limb_type small[INLINE_LIMBS] = {};
+    limb_type* heap = nullptr;
+    size_t n = 0;                   // the significant limbs, 0 for 0
+    size_t cap = INLINE_LIMBS;
+    bool neg = false;
+    [[no_unique_address]] Allocator alloc;
+
+    constexpr limb_type* data() noexcept {
+        return cap > INLINE_LIMBS ? heap : small;
+    }
+
+    constexpr const limb_type* data() const noexcept {
+        return cap > INLINE_LIMBS ? heap : small;
+    }
+
+    constexpr void release() noexcept {
+        if (cap > INLINE_LIMBS) traits::deallocate(alloc, heap, cap);
+        heap = nullptr;
+        cap = INLINE_LIMBS;
+    }
+
+    // room for m limbs keeping the significant ones, at least doubling on growth
+    constexpr void reserve(size_t m) {
+        if (m <= cap) return;
+        size_t c = std::max(m, 2 * cap);
+        limb_type* p = traits::allocate(alloc, c);
+        limb::copy_n(p, data(), n);
+        release();
+        heap = p;
+        cap = c;
+    }
+
+    constexpr void trim() noexcept {
+        const limb_type* d = data();
+        while (n && !d[n - 1]) --n;
+        if (!n) neg = false;
+    }
+
+    constexpr void assign(basic_big_int const& rhs) {
+        if (this == &rhs) return;
+        reserve(rhs.n);
+        limb::copy_n(data(), rhs.data(), rhs.n);
+        n = rhs.n;
+        neg = rhs.neg;
+    }
+
+    // takes the storage of rhs, whose allocator must be able to free it
+    constexpr void steal(basic_big_int& rhs) noexcept {
+        release();
+        if (rhs.cap > INLINE_LIMBS) {
+            heap = std::exchange(rhs.heap, nullptr);
+            cap = std::exchange(rhs.cap, INLINE_LIMBS);
+        } else {
+            limb::copy_n(small, rhs.small, rhs.n);
+        }
+        n = std::exchange(rhs.n, 0);
+        neg = std::exchange(rhs.neg, false);
+    }
+
+    // a number on the same allocator with room for m limbs
+    constexpr basic_big_int with_room(size_t m) const {
+        basic_big_int ret(alloc);
+        ret.reserve(m);
+        return ret;
+    }
+
+    // this += (-1)^negate * rhs, where rhs may be this
+    constexpr void add_signed(basic_big_int const& rhs, bool negate) {
+        if (!rhs.n) return;
+        bool rneg = rhs.neg != negate;
+        if (neg == rneg || !n) {
+            size_t rn = rhs.n, m = std::max(n, rn);
+            reserve(m + 1);
+            limb_type* d = data();
+            limb::zero_n(d + n, m + 1 - n);
+            d[m] = limb::add_to(d, m, rhs.data(), rn);
+            n = m + 1;
+            neg = rneg;
+        } else if (limb::cmp_sized(data(), n, rhs.data(), rhs.n) >= 0) {
+            limb::sub_from(data(), n, rhs.data(), rhs.n);
+        } else {
+            // the magnitude of rhs wins along with its sign
+            size_t rn = rhs.n;
+            reserve(rn);
+            limb_type* d = data();
+            const limb_type* b = rhs.data();
+            limb_type borrow = 0;
+            for (size_t i = 0; i < rn; ++i) d[i] = limb::subb(b[i], i < n ? d[i] : limb_type(0), borrow);
+            n = rn;
+            neg = rneg;
+        }
+        trim();
+    }
+
+    // r = |x| * |y| in full, r is neither x nor y
+    static constexpr void mul_abs(basic_big_int& r, basic_big_int const& x, basic_big_int const& y) {
+        const basic_big_int* a = &x;
+        const basic_big_int* b = &y;
+        if (a->n < b->n) std::swap(a, b);
+        r.n = 0;
+        if (!b->n) return;
+        r.reserve(a->n + b->n);
+        if (size_t s = limb::mul_scratch(a->n, b->n)) {
+            basic_big_int scratch = x.with_room(s);
+            limb::mul(r.data(), a->data(), a->n, b->data(), b->n, scratch.data());
+        } else {
+            limb::mul_basecase(r.data(), a->data(), a->n, b->data(), b->n);
+        }
+        r.n = a->n + b->n;
+    }
+
+public:
+    constexpr basic_big_int() noexcept(noexcept(Allocator())) = default;
+
+    constexpr explicit basic_big_int(Allocator const& a) noexcept : alloc(a) {}
+
+    template<std::integral T> requires (!std::is_same_v<T, bool>)
+    constexpr basic_big_int(T value, Allocator const& a = Allocator()) noexcept : alloc(a) {
+        using U = std::make_unsigned_t<T>;
+        neg = value < 0;
+        U mag = neg ? U(U(0) - U(value)) : U(value);
+        while (mag) {
+            small[n++] = limb_type(mag);
+            if constexpr (sizeof(U) > sizeof(limb_type)) mag >>= LIMB_BITS;
+            else mag = 0;
+        }
+    }
+
+    // the value of x, even the minimum of a signed width keeps its magnitude
+    template<size_t N, bool S>
+    constexpr explicit basic_big_int(wide_int<N, S> const& x, Allocator const& a = Allocator()) : alloc(a) {
+        using W = wide_int<N, false>;
+        W mag = x.abs();
+        reserve((N + LIMB_BITS - 1) / LIMB_BITS);
+        limb_type* d = data();
+        n = (N + LIMB_BITS - 1) / LIMB_BITS;
+        limb::zero_n(d, n);
+        for (size_t i = 0; i < W::LIMBS; ++i) {
+            size_t pos = i * W::LIMB_BITS;
+            d[pos / LIMB_BITS] |= limb_type(mag.limbs[i]) << (pos % LIMB_BITS);
+        }
+        neg = x.is_negative();
+        trim();
+    }
+
+    constexpr basic_big_int(basic_big_int const& rhs)
+        : alloc(traits::select_on_container_copy_construction(rhs.alloc)) {
+        assign(rhs);
+    }
+
+    constexpr basic_big_int(basic_big_int const& rhs, Allocator const& a) : alloc(a) {
+        assign(rhs);
+    }
+
+    // from a number on another kind of allocator
+    template<typename A> requires (!std::is_same_v<A, Allocator>)
+    constexpr explicit basic_big_int(basic_big_int<A> const& rhs, Allocator const& a = Allocator()) : alloc(a) {
+        reserve(rhs.significant_limbs());
+        limb::copy_n(data(), rhs.limbs(), rhs.significant_limbs());
+        n = rhs.significant_limbs();
+        neg = rhs.is_negative();
+    }
+
+    constexpr basic_big_int(basic_big_int&& rhs) noexcept : alloc(std::move(rhs.alloc)) {
+        steal(rhs);
+    }
+
+    constexpr ~basic_big_int() {
+        release();
+    }
+
+    constexpr basic_big_int& operator=(basic_big_int const& rhs) {
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (alloc != rhs.alloc) {
+                release();
+                n = 0;
+            }
+            alloc = rhs.alloc;
+        }
+        assign(rhs);
+        return *this;
+    }
+
+    constexpr basic_big_int& operator=(basic_big_int&& rhs) noexcept(
+            traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value) {
+        if (this == &rhs) return *this;
+        if constexpr (traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc = std::move(rhs.alloc);
+            steal(rhs);
+        } else if (traits::is_always_equal::value || alloc == rhs.alloc) {
+            steal(rhs);
+        } else {
+            // the storage of another arena must stay there
+            assign(rhs);
+        }
+        return *this;
+    }
+
+    constexpr allocator_type get_allocator() const noexcept {
+        return alloc;
+    }
+
+    friend constexpr void swap(basic_big_int& x, basic_big_int& y) noexcept {
+        basic_big_int t(std::move(x));
+        x = std::move(y);
+        y = std::move(t);
+    }
+
+    // the limbs of the magnitude, which are significant_limbs() long
+    constexpr const limb_type* limbs() const noexcept {
+        return data();
+    }
+
+    constexpr size_t significant_limbs() const noexcept {
+        return n;
+    }
+
+    constexpr bool is_negative() const noexcept {
+        return neg;
+    }
+
+    // -1, 0 or 1
+    constexpr int sign() const noexcept {
+        return neg ? -1 : n ? 1 : 0;
+    }
+
+    explicit constexpr operator bool() const noexcept {
+        return n;
+    }
+
+    // the bits of the magnitude
+    constexpr size_t bit_width() const noexcept {
+        return limb::bit_width(data(), n);
+    }
+
+    // the low bits of the two's complement, as wide_int converts its wider types
+    template<std::integral Integral>
+    constexpr Integral to_integral() const noexcept {
+        static_assert(!std::is_same_v<Integral, bool>, "use operator bool() instead");
+        using U = std::make_unsigned_t<Integral>;
+        U ret = 0;
+        for (size_t i = 0; i < n && i * LIMB_BITS < (sizeof(U) << 3); ++i) {
+            ret |= U(data()[i]) << (i * LIMB_BITS);
+        }
+        if (neg) ret = U(U(0) - ret);
+        return static_cast<Integral>(ret);
+    }
+
+    template<std::integral Integral>
+    explicit constexpr operator Integral() const noexcept {
+        return to_integral<Integral>();
+    }
+
+    // the value modulo 2^N, as a wide_int<N, S> converts from a wider one
+    template<size_t N, bool S>
+    constexpr wide_int<N, S> to_wide_int() const noexcept {
+        using W = wide_int<N, S>;
+        W ret;
+        const limb_type* d = data();
+        for (size_t i = 0; i < W::LIMBS; ++i) {
+            size_t pos = i * W::LIMB_BITS;
+            if (pos / LIMB_BITS < n) ret.limbs[i] = typename W::limb_type(d[pos / LIMB_BITS] >> (pos % LIMB_BITS));
+        }
+        if (neg) ret.negative();
+        return ret;
+    }
+
+    template<size_t N, bool S>
+    explicit constexpr operator wide_int<N, S>() const noexcept {
+        return to_wide_int<N, S>();
+    }
+
+    constexpr basic_big_int operator+() const& {
+        return *this;
+    }
+
+    constexpr basic_big_int operator+() && noexcept {
+        return std::move(*this);
+    }
+
+    constexpr basic_big_int operator-() const& {
+        basic_big_int ret(*this);
+        return -std::move(ret);
+    }
+
+    constexpr basic_big_int operator-() && noexcept {
+        if (n) neg = !neg;
+        return std::move(*this);
+    }
+
+    friend constexpr basic_big_int abs(basic_big_int x) noexcept {
+        x.neg = false;
+        return x;
+    }
+
+    constexpr basic_big_int& operator+=(basic_big_int const& rhs) {
+        add_signed(rhs, false);
+        return *this;
+    }
+
+    constexpr basic_big_int& operator-=(basic_big_int const& rhs) {
+        add_signed(rhs, true);
+        return *this;
+    }
+
+    constexpr basic_big_int& operator++() {
+        return *this += basic_big_int(1);
+    }
+
+    constexpr basic_big_int& operator--() {
+        return *this -= basic_big_int(1);
+    }
+
+    constexpr basic_big_int operator++(int) {
+        basic_big_int ret(*this);
+        ++*this;
+        return ret;
+    }
+
+    constexpr basic_big_int operator--(int) {
+        basic_big_int ret(*this);
+        --*this;
+        return ret;
+    }
+
+    constexpr basic_big_int& operator*=(basic_big_int const& rhs) {
+        bool sign = neg != rhs.neg;
+        if (rhs.n == 1 && n) {
+            // a single limb multiplies in place
+            reserve(n + 1);
+            limb_type* d = data();
+            d[n] = limb::mul_1(d, d, n, rhs.data()[0]);
+            ++n;
+        } else {
+            basic_big_int ret = with_room(n + rhs.n);
+            mul_abs(ret, *this, rhs);
+            *this = std::move(ret);
+        }
+        neg = sign;
+        trim();
+        return *this;
+    }
+
+    struct div_t {
+        basic_big_int quot, rem;
+    };
+
+    // truncates towards zero, the remainder takes the sign of the dividend
+    constexpr div_t div(basic_big_int const& rhs) const {
+        if (!rhs.n) throw std::invalid_argument("divided by 0");
+        if (n < rhs.n) return {basic_big_int(alloc), *this};
+        div_t ret{with_room(n - rhs.n + 1), with_room(rhs.n)};
+        if (rhs.n == 1) {
+            ret.rem.data()[0] = limb::divrem_1(ret.quot.data(), data(), n, rhs.data()[0]);
+        } else {
+            basic_big_int scratch = with_room(limb::divrem_scratch(n, rhs.n));
+            limb::divrem(ret.quot.data(), ret.rem.data(), data(), n, rhs.data(), rhs.n, scratch.data());
+        }
+        ret.quot.n = n - rhs.n + 1;
+        ret.quot.neg = neg != rhs.neg;
+        ret.quot.trim();
+        ret.rem.n = rhs.n;
+        ret.rem.neg = neg;
+        ret.rem.trim();
+        return ret;
+    }
+
+    constexpr basic_big_int& operator/=(basic_big_int const& rhs) {
+        return *this = div(rhs).quot;
+    }
+
+    constexpr basic_big_int& operator%=(basic_big_int const& rhs) {
+        return *this = div(rhs).rem;
+    }
+
+    constexpr basic_big_int& operator<<=(size_t rhs) {
+        if (!n) return *this;
+        size_t m = n + rhs / LIMB_BITS + 1;
+        reserve(m);
+        limb_type* d = data();
+        limb::zero_n(d + n, m - n);
+        limb::shift_left(d, d, m, rhs);
+        n = m;
+        trim();
+        return *this;
+    }
+
+    // rounds towards negative infinity as the arithmetic shift of two's complement does
+    constexpr basic_big_int& operator>>=(size_t rhs) {
+        if (!n) return *this;
+        bool inexact = neg && limb::countr_zero(data(), n) < rhs;
+        limb::shift_right(data(), data(), n, rhs);
+        trim();
+        if (inexact) *this -= basic_big_int(1);
+        return *this;
+    }
+
+    friend constexpr basic_big_int operator+(basic_big_int const& x, basic_big_int const& y) {
+        basic_big_int ret(x);
+        return ret += y;
+    }
+
+    friend constexpr basic_big_int operator+(basic_big_int&& x, basic_big_int const& y) {
+        return std::move(x += y);
+    }
+
+    friend constexpr basic_big_int operator+(basic_big_int const& x, basic_big_int&& y) {
+        return std::move(y += x);
+    }
+
+    friend constexpr basic_big_int operator+(basic_big_int&& x, basic_big_int&& y) {
+        return std::move(x += y);
+    }
+
+    friend constexpr basic_big_int operator-(basic_big_int const& x, basic_big_int const& y) {
+        basic_big_int ret(x);
+        return ret -= y;
+    }
+
+    friend constexpr basic_big_int operator-(basic_big_int&& x, basic_big_int const& y) {
+        return std::move(x -= y);
+    }
+
+    friend constexpr basic_big_int operator-(basic_big_int const& x, basic_big_int&& y) {
+        return -std::move(y -= x);
+    }
+
+    friend constexpr basic_big_int operator-(basic_big_int&& x, basic_big_int&& y) {
+        return std::move(x -= y);
+    }
+
+    friend constexpr basic_big_int operator*(basic_big_int const& x, basic_big_int const& y) {
+        basic_big_int ret = x.with_room(x.n + y.n);
+        mul_abs(ret, x, y);
+        ret.neg = x.neg != y.neg;
+        ret.trim();
+        return ret;
+    }
+
+    friend constexpr basic_big_int operator*(basic_big_int&& x, basic_big_int const& y) {
+        return std::move(x *= y);
+    }
+
+    friend constexpr basic_big_int operator*(basic_big_int const& x, basic_big_int&& y) {
+        return std::move(y *= x);
+    }
+
+    friend constexpr basic_big_int operator*(basic_big_int&& x, basic_big_int&& y) {
+        return std::move(x *= y);
+    }
+
+    friend constexpr basic_big_int operator/(basic_big_int const& x, basic_big_int const& y) {
+        return x.div(y).quot;
+    }
+
+    friend constexpr basic_big_int operator%(basic_big_int const& x, basic_big_int const& y) {
+        return x.div(y).rem;
+    }
+
+    friend constexpr basic_big_int operator<<(basic_big_int x, size_t y) {
+        return std::move(x <<= y);
+    }
+
+    friend constexpr basic_big_int operator>>(basic_big_int x, size_t y) {
+        return std::move(x >>= y);
+    }
+
+    friend constexpr bool operator==(basic_big_int const& x, basic_big_int const& y) noexcept {
+        return x.neg == y.neg && x.n == y.n && limb::cmp_n(x.data(), y.data(), x.n) == 0;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(basic_big_int const& x, basic_big_int const& y) noexcept {
+        if (x.neg != y.neg) return x.neg ? std::strong_ordering::less : std::strong_ordering::greater;
+        int cmp = limb::cmp_sized(x.data(), x.n, y.data(), y.n);
+        return (x.neg ? -cmp : cmp) <=> 0;
+    }
+
+    // the greatest common divisor of |x| and |y|, which is non-negative
+    friend constexpr basic_big_int gcd(basic_big_int const& x, basic_big_int const& y) {
+        if (!x.n) return abs(y);
+        if (!y.n) return abs(x);
+        size_t m = std::max(x.n, y.n);
+        // both operands padded to m limbs, the result and the scratch in one block
+        basic_big_int buf = x.with_room(3 * m + limb::gcd_scratch(m));
+        limb_type* a = buf.data();
+        limb_type* b = a + m;
+        basic_big_int ret = x.with_room(m);
+        limb::zero_n(a, 2 * m);
+        limb::copy_n(a, x.data(), x.n);
+        limb::copy_n(b, y.data(), y.n);
+        ret.n = limb::gcd(ret.data(), a, x.n, b, y.n, b + m);
+        return ret;
+    }
+
+    friend constexpr basic_big_int lcm(basic_big_int const& x, basic_big_int const& y) {
+        if (!x.n || !y.n) return basic_big_int(x.alloc);
+        return abs(x) / gcd(x, y) * abs(y);
+    }
+
+    constexpr std::string to_string(int base = 10, bool uppercase = false) const {
+        int_base::assertValid(base);
+        std::string buf(radix::max_digits(std::max<size_t>(n, 1) * LIMB_BITS, base) + 1, '\0');
+        char* last = buf.data() + buf.size();
+        // the conversion destroys the limbs
+        basic_big_int mag(*this);
+        char* first = radix::to_chars(last, mag.data(), n, base, uppercase);
+        if (neg) *--first = '-';
+        return {first, last};
+    }
+
+    friend std::string toTex(basic_big_int const& x) {
+        return x.to_string();
+    }
+
+    // the digits in [first, last) without sign or prefix
+    static constexpr basic_big_int parse(const char* first, const char* last, int base, bool neg = false,
+                                         Allocator const& a = Allocator()) {
+        if (first == last) throw std::invalid_argument("invalid string");
+        for (const char* it = first; it != last; ++it) {
+            if (int_base::from_char_raw(*it, base) < 0) throw std::invalid_argument("invalid string");
+        }
+        basic_big_int ret(a);
+        size_t m = radix::max_limbs<limb_type>(last - first, base);
+        ret.reserve(m);
+        radix::from_chars(ret.data(), m, first, last, base);
+        ret.n = m;
+        ret.neg = neg;
+        ret.trim();
+        return ret;
+    }
+
+    static constexpr basic_big_int from_string(const char* cp, int base = 10, Allocator const& a = Allocator()) {
+        int_base::assertValid(base);
+        if (cp == 0 || *cp == 0) throw std::invalid_argument("invalid string");
+        bool neg = false;
+        switch (cp[0]) {
+            case '-': neg = true;
+            case '+': ++cp;
+        }
+        return parse(cp, cp + std::char_traits<char>::length(cp), base, neg, a);
+    }
+
+    // with the prefixes 0b, 0x and 0 for binary, hexadecimal and octal
+    static constexpr basic_big_int from_string_based(const char* cp, Allocator const& a = Allocator()) {
+        if (cp == 0 || *cp == 0) throw std::invalid_argument("invalid string");
+        bool neg = false;
+        switch (cp[0]) {
+            case '-': neg = true;
+            case '+': ++cp;
+        }
+        int base = 10;
+        if (cp[0] == '0' && cp[1]) {
+            switch (cp[1]) {
+                case 'b': case 'B': base = 2; cp += 2; break;
+                case 'x': case 'X': base = 16; cp += 2; break;
+                default: base = 8; ++cp;
+            }
+        }
+        return parse(cp, cp + std::char_traits<char>::length(cp), base, neg, a);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, basic_big_int const& rhs) {
+        std::ios::fmtflags f = os.flags();
+        int base = f & std::ios::oct ? 8 : f & std::ios::hex ? 16 : 10;
+        if ((f & std::ios::showpos) && !rhs.neg) os << '+';
+        if (f & std::ios::showbase) {
+            if (rhs.neg) os << '-';
+            if (base == 8 && rhs) os << '0';
+            if (base == 16) os << "0x";
+            return os << abs(rhs).to_string(base, f & std::ios::uppercase);
+        }
+        return os << rhs.to_string(base, f & std::ios::uppercase);
+    }
+
+    friend std::istream& operator>>(std::istream& is, basic_big_int& rhs) {
+        std::ios::fmtflags f = is.flags();
+        int base = f & std::ios::oct ? 8 : f & std::ios::hex ? 16 : 10;
+        bool neg = false;
+        if (is) {
+            switch (is.get()) {
+                case '-': neg = true;
+                case '+': break;
+                default: is.unget();
+            }
+        }
+        std::string digits;
+        while (is) {
+            int ch = is.peek();
+            if (ch == EOF || int_base::from_char_raw(char(ch), base) < 0) break;
+            digits += char(is.get());
+        }
+        if (!digits.empty()) {
+            rhs = parse(digits.data(), digits.data() + digits.size(), base, neg, rhs.alloc);
+        } else {
+            is.setstate(std::ios::failbit);
+        }
+        return is;
+    }
+};
+
+using big_int = basic_big_int<>;
+
+namespace pmr {
+// takes its limbs from a std::pmr::memory_resource such as an arena
+using big_int = basic_big_int<std::pmr::polymorphic_allocator<std::uint64_t>>;
+}
+
+inline namespace big_int_literals {
+constexpr big_int operator"" _big(const char* s) {
+    return big_int::from_string_based(s);
+}
+}
+
+}
+
+#endif
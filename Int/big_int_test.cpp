@@ -0,0 +1,42 @@
+#include "big_int.cpp"
+#include "rational.cpp"
+
+#include <iostream>
+#include <sstream>
+
+using namespace yao_math::big_int_literals;
+
+// 3^100 fits inline, 3^1000 goes to the heap, and both agree with wide_int
+static_assert(yao_math::pow(yao_math::big_int(3), 100) == yao_math::big_int(yao_math::pow(yao_math::uint256(3), 100)));
+static_assert(yao_math::pow(yao_math::big_int(3), 1000).to_wide_int<2048, false>() == yao_math::pow(yao_math::uint2048(3), 1000));
+static_assert(yao_math::pow(yao_math::big_int(3), 1000).to_string() == yao_math::pow(yao_math::uint2048(3), 1000).to_string());
+static_assert(yao_math::big_int(-(yao_math::sint128(1) << 127)).to_string() == "-170141183460469231731687303715884105728");
+static_assert(yao_math::big_int(-7).to_wide_int<24, true>() == yao_math::wide_int<24, true>(-7));
+// the division truncates as the built-in integers do, the shift rounds down
+static_assert(yao_math::big_int(-7) / 2 == -3 && yao_math::big_int(-7) % 2 == -1 && (yao_math::big_int(-7) >> 1) == -4);
+static_assert((yao_math::big_int(1) << 300 >> 299) == 2);
+static_assert(123456789012345678901234567890123456789_big - 123456789012345678901234567890123456790_big == -1);
+static_assert(0x100000000000000000000000000000000_big % 0xFFFFFFFFFFFFFFFF_big == 1);
+static_assert([] {
+    yao_math::big_int x = yao_math::pow(yao_math::big_int(10), 60) + 7, y = x * x;
+    y -= x * 14;
+    return y / x == x - 14 && y % x == 0 && gcd(y, x * 6) == x * 3 && lcm(yao_math::big_int(-4), yao_math::big_int(6)) == 12;
+}());
+// exact rationals without picking a width
+static_assert(yao_math::Rational<yao_math::big_int>(yao_math::pow(yao_math::big_int(2), 200), 6)
+    * yao_math::Rational<yao_math::big_int>(3, yao_math::pow(yao_math::big_int(2), 199)) == yao_math::Rational<yao_math::big_int>(1));
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    // the limbs of the heap numbers come from the arena and are never freed one by one
+    std::byte buffer[1 << 14];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof buffer);
+    yao_math::pmr::big_int f(1, &arena);
+    for (int i = 2; i <= 100; ++i) f *= i;
+    cout << f << endl;
+    stringstream ss("-123456789012345678901234567890");
+    big_int x;
+    ss >> x;
+    cout << hex << showbase << x << endl;
+}
@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include "wide_int.cpp"
+
+#ifndef YAO_MATH_DIVISOR
+#define YAO_MATH_DIVISOR
+
+namespace yao_math {
+
+/*
+ * division by an invariant divisor, which is normalized with the reciprocal
+ * of its highest limb once so that every division is left with multiplications
+ * and corrections, Moller & Granlund for a single limb and Algorithm D above
+ *
+ * the results are those of wide_int::div, truncating towards zero
+ */
+template<typename T>
+class divisor;
+
+template<size_t N, bool S>
+class divisor<wide_int<N, S>> {
+public:
+    using value_type = wide_int<N, S>;
+    using limb_type = typename value_type::limb_type;
+    using div_t = typename value_type::div_t;
+
+private:
+    using magnitude_type = wide_int<N, false>;
+    constexpr static size_t LIMBS = value_type::LIMBS;
+
+    value_type d;
+    size_t n;                       // the significant limbs of the magnitude
+    unsigned shift;                 // the normalization shift of the highest limb
+    size_t pow2;                    // log2 of a power of two, which only takes a shift and a mask
+    magnitude_type v;               // the magnitude shifted up to the highest bit of its highest limb
+    limb::inverse<limb_type> inv;   // of the single limb, or of the highest limb of v
+
+    static constexpr magnitude_type magnitude(value_type const& d) {
+        if (!d) throw std::invalid_argument("divided by 0");
+        return d.abs().to_unsigned();
+    }
+
+    constexpr divisor(value_type const& d, magnitude_type const& m) :
+        d(d), n(m.significant_limbs()), shift(std::countl_zero(m.limbs[n - 1])),
+        pow2(m.popcount() == 1 ? m.countr_zero() : 0), v(m << shift), inv(n == 1 ? m.limbs[0] : v.limbs[n - 1]) {}
+
+    // the division of the magnitudes, the quotient has LIMBS limbs and the remainder n
+    constexpr void divrem_abs(limb_type* q, limb_type* r, magnitude_type const& a) const noexcept {
+        size_t an = a.significant_limbs();
+        if (an < n) {
+            limb::copy_n(r, a.limbs, n);
+        } else if (pow2) {
+            limb::shift_right(q, a.limbs, LIMBS, pow2);
+            limb::copy_n(r, a.limbs, n);
+            r[n - 1] &= limb_type((limb_type(1) << pow2 % value_type::LIMB_BITS) - 1);
+        } else if (n == 1) {
+            r[0] = limb::divrem_1(q, a.limbs, an, inv);
+        } else {
+            limb_type u[LIMBS + 1];
+            if (shift) {
+                u[an] = limb::lshift(u, a.limbs, an, shift);
+            } else {
+                limb::copy_n(u, a.limbs, an);
+                u[an] = 0;
+            }
+            limb::divrem_normalized(q, u, an, v.limbs, n, inv.v);
+            if (shift) limb::rshift(r, u, n, shift);
+            else limb::copy_n(r, u, n);
+        }
+    }
+
+public:
+    constexpr explicit divisor(value_type const& d) : divisor(d, magnitude(d)) {}
+
+    constexpr value_type const& value() const noexcept {
+        return d;
+    }
+
+    constexpr div_t divrem(value_type const& a) const noexcept {
+        div_t ret;
+        divrem_abs(ret.quot.limbs, ret.rem.limbs, a.abs().to_unsigned());
+        if (a.is_negative() != d.is_negative()) ret.quot.negative();
+        if (a.is_negative()) ret.rem.negative();
+        return ret;
+    }
+
+    constexpr value_type quot(value_type const& a) const noexcept {
+        return divrem(a).quot;
+    }
+
+    // a single limb keeps only the remainder
+    constexpr value_type rem(value_type const& a) const noexcept {
+        if (n > 1 || pow2) return divrem(a).rem;
+        magnitude_type x = a.abs().to_unsigned();
+        size_t an = x.significant_limbs();
+        value_type ret = an ? limb::mod_1(x.limbs, an, inv) : limb_type(0);
+        return a.is_negative() ? -ret : ret;
+    }
+
+    constexpr bool divides(value_type const& a) const noexcept {
+        return !rem(a);
+    }
+
+    friend constexpr value_type operator/(value_type const& a, divisor const& d) noexcept {
+        return d.quot(a);
+    }
+
+    friend constexpr value_type operator%(value_type const& a, divisor const& d) noexcept {
+        return d.rem(a);
+    }
+};
+
+// a divisor known at compile time, so that its normalization and reciprocal are constants
+template<typename T, T D>
+struct constant_divisor {
+    constexpr static divisor<T> value{D};
+
+    friend constexpr T operator/(T const& a, constant_divisor) noexcept {
+        return value.quot(a);
+    }
+
+    friend constexpr T operator%(T const& a, constant_divisor) noexcept {
+        return value.rem(a);
+    }
+};
+
+}
+
+#endif
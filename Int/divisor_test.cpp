@@ -0,0 +1,37 @@
+#include "divisor.cpp"
+
+#include <iostream>
+
+using ten = yao_math::constant_divisor<yao_math::uint256, yao_math::uint256(10)>;
+using p61 = yao_math::constant_divisor<yao_math::sint128, (yao_math::sint128(1) << 61) - yao_math::sint128(1)>;
+
+// a constant single limb divides by multiply-high and correction
+static_assert(yao_math::pow(yao_math::uint256(3), 100) / ten{} == yao_math::pow(yao_math::uint256(3), 100) / yao_math::uint256(10));
+static_assert(yao_math::pow(yao_math::uint256(3), 100) % ten{} == yao_math::uint256(1));
+static_assert((yao_math::sint128(-1) << 100) % p61{} == -((yao_math::sint128(1) << 100) % ((yao_math::sint128(1) << 61) - yao_math::sint128(1))));
+// the results truncate like wide_int::div, also for the minimum and a power of two
+constexpr yao_math::sint512 big = -(yao_math::sint512(1) << 400) + yao_math::sint512(12345);
+static_assert([] {
+    for (auto d : {(yao_math::sint512(1) << 130) - yao_math::sint512(7), yao_math::sint512(-1000000007),
+                   -(yao_math::sint512(1) << 200), yao_math::sint512(-1), -(yao_math::sint512(1) << 511)}) {
+        yao_math::divisor<yao_math::sint512> divisor(d);
+        auto expected = big.div(d), actual = divisor.divrem(big);
+        if (expected.quot != actual.quot || expected.rem != actual.rem || big % divisor != expected.rem) return false;
+    }
+    return yao_math::divisor<yao_math::uint256>(yao_math::uint256(1000000007)).divides(yao_math::uint256(1000000007) * yao_math::uint256(998244353));
+}());
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    // trial division of 2^128 - 1 by the odd numbers, with one reciprocal each
+    uint256 n = (uint256(1) << 128) - uint256(1);
+    for (unsigned p = 3; p < 70000; p += 2) {
+        divisor<uint256> d(p);
+        while (d.divides(n)) {
+            cout << p << ' ';
+            n = n / d;
+        }
+    }
+    cout << n << endl;
+}
@@ -0,0 +1,250 @@
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <map>
+#include <span>
+#include <bit>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "primality.cpp"
+
+#ifndef YAO_MATH_FACTOR
+#define YAO_MATH_FACTOR
+
+namespace yao_math {
+
+namespace factoring {
+
+constexpr uint64_t TRIAL_LIMIT = 1 << 10;
+
+constexpr size_t count_trial_primes() {
+    size_t ret = 0;
+    for (uint64_t i = 3; i < TRIAL_LIMIT; i += 2) {
+        bool prime = true;
+        for (uint64_t j = 3; j * j <= i && prime; j += 2) prime = i % j;
+        ret += prime;
+    }
+    return ret;
+}
+
+// the odd primes below TRIAL_LIMIT, divided out as in primality::prefilter
+constexpr auto trial_primes = [] {
+    std::array<primality::small_prime, count_trial_primes()> ret{};
+    size_t n = 0;
+    for (uint64_t i = 3; i < TRIAL_LIMIT; i += 2) {
+        bool prime = true;
+        for (uint64_t j = 3; j * j <= i && prime; j += 2) prime = i % j;
+        if (!prime) continue;
+        uint64_t inv = i;
+        for (int j = 0; j < 5; ++j) inv *= 2 - i * inv;
+        ret[n++] = {i, inv, UINT64_MAX / i};
+    }
+    return ret;
+}();
+
+// the binary algorithm, which takes no division
+constexpr uint64_t gcd(uint64_t a, uint64_t b) noexcept {
+    if (!a || !b) return a | b;
+    int shift = std::countr_zero(a | b);
+    a >>= std::countr_zero(a);
+    while (b) {
+        b >>= std::countr_zero(b);
+        if (a > b) std::swap(a, b);
+        b -= a;
+    }
+    return a << shift;
+}
+
+constexpr uint64_t isqrt(uint64_t n) noexcept {
+    uint64_t r = uint64_t(std::sqrt(double(n)));
+    while (r * r > n) --r;
+    while ((r + 1) * (r + 1) <= n && r < UINT32_MAX) ++r;
+    return r;
+}
+
+/*
+ * Pollard's rho with the cycle detection of Brent on x -> x^2 + c mod n,
+ * the differences being multiplied BATCH at a time so that a gcd is taken
+ * once per batch, and one by one again from the last batch when it overshoots;
+ * returns a factor of the odd composite n, or n itself when c fails
+ */
+constexpr uint64_t pollard_brent(uint64_t n, uint64_t c) noexcept {
+    constexpr uint64_t BATCH = 128;
+    montgomery64 ctx(n);
+    // everything stays in the Montgomery form, which keeps the gcd with n
+    uint64_t cm = ctx.to_montgomery(c);
+    auto f = [&](uint64_t x) {
+        uint64_t y = ctx.mul(x, x), sum = y + cm;
+        return sum < y || sum >= n ? sum - n : sum;
+    };
+    auto distance = [](uint64_t x, uint64_t y) {
+        return x > y ? x - y : y - x;
+    };
+    uint64_t x = 0, y = ctx.to_montgomery(2), saved = y, q = ctx.one, g = 1;
+    for (uint64_t r = 1; g == 1; r *= 2) {
+        x = y;
+        for (uint64_t i = 0; i < r; ++i) y = f(y);
+        for (uint64_t k = 0; k < r && g == 1; k += BATCH) {
+            saved = y;
+            for (uint64_t i = 0; i < std::min(BATCH, r - k); ++i) {
+                y = f(y);
+                q = ctx.mul(q, distance(x, y));
+            }
+            g = gcd(q, n);
+        }
+    }
+    if (g == n) {
+        do {
+            saved = f(saved);
+            g = gcd(distance(x, saved), n);
+        } while (g == 1);
+    }
+    return g;
+}
+
+// the multipliers of SQUFOF, a run of which finds a factor of almost any n
+constexpr uint64_t squfof_multipliers[] = {1, 3, 5, 7, 11, 3 * 5, 3 * 7, 3 * 11, 5 * 7, 5 * 11, 7 * 11,
+                                           3 * 5 * 7, 3 * 5 * 11, 3 * 7 * 11, 5 * 7 * 11, 3 * 5 * 7 * 11};
+
+/*
+ * the square forms factorization of Shanks on the continued fraction of sqrt(k n),
+ * for the odd composite n < 2^62 which is not a square; returns 1 when all multipliers fail
+ */
+constexpr uint64_t squfof(uint64_t n) noexcept {
+    for (uint64_t k : squfof_multipliers) {
+        if (n > (uint64_t(1) << 62) / k) break;
+        int64_t kn = int64_t(k * n), p0 = int64_t(isqrt(uint64_t(kn)));
+        int64_t p = p0, p_prev = p0, q_prev = 1, q = kn - p0 * p0;
+        if (!q) continue;
+        int64_t bound = 3 * int64_t(2 * std::sqrt(2 * std::sqrt(double(kn))));
+        // forward to a square form Q = r^2 at an even step
+        int64_t i = 2, r = 0;
+        for (; i < bound; ++i) {
+            int64_t b = (p0 + p) / q;
+            p = b * q - p;
+            int64_t t = q;
+            q = q_prev + b * (p_prev - p);
+            r = int64_t(isqrt(uint64_t(q)));
+            if (!(i & 1) && r * r == q) break;
+            q_prev = t;
+            p_prev = p;
+        }
+        if (i >= bound) continue;
+        // backward from its square root until P repeats
+        int64_t b = (p0 - p) / r;
+        p_prev = p = b * r + p;
+        q_prev = r;
+        q = (kn - p_prev * p_prev) / q_prev;
+        for (i = 0; i < bound; ++i) {
+            b = (p0 + p) / q;
+            p_prev = p;
+            p = b * q - p;
+            int64_t t = q;
+            q = q_prev + b * (p_prev - p);
+            q_prev = t;
+            if (p == p_prev) break;
+        }
+        uint64_t f = gcd(n, uint64_t(p));
+        if (f != 1 && f != n) return f;
+    }
+    return 1;
+}
+
+// a nontrivial factor of the odd composite n
+constexpr uint64_t find_factor(uint64_t n) noexcept {
+    uint64_t r = isqrt(n);
+    if (r * r == n) return r;
+    for (uint64_t c = 1; c < 64; ++c) {
+        uint64_t d = pollard_brent(n, c);
+        if (d != n) return d;
+    }
+    if (n < uint64_t(1) << 62) {
+        if (uint64_t d = squfof(n); d != 1) return d;
+    }
+    // never reached in practice, but the trial division always ends
+    for (uint64_t d = 3;; d += 2) if (n % d == 0) return d;
+}
+
+// appends the prime factors of the odd n > 1 without small factors
+constexpr void factor_large(uint64_t n, std::vector<uint64_t>& out) {
+    if (is_prime(n)) {
+        out.push_back(n);
+        return;
+    }
+    uint64_t d = find_factor(n);
+    factor_large(d, out);
+    factor_large(n / d, out);
+}
+
+}
+
+/*
+ * appends the prime factors of n > 0 with their multiplicity, in ascending order,
+ * by trial division up to 2^10, Miller-Rabin and Pollard-Brent rho
+ */
+constexpr void factor(uint64_t n, std::vector<uint64_t>& out) {
+    using namespace factoring;
+    if (!n) throw std::invalid_argument("0 has no factorization");
+    size_t begin = out.size();
+    int twos = std::countr_zero(n);
+    out.insert(out.end(), twos, 2);
+    n >>= twos;
+    for (auto const& each : trial_primes) {
+        if (each.p * each.p > n) break;
+        // p divides n exactly when n * inv is an integer below 2^64 / p
+        while (n * each.inv <= each.limit) {
+            out.push_back(each.p);
+            n *= each.inv;
+        }
+    }
+    if (n == 1) return;
+    if (n < TRIAL_LIMIT * TRIAL_LIMIT) {
+        out.push_back(n);
+        return;
+    }
+    factor_large(n, out);
+    std::sort(out.begin() + begin, out.end());
+}
+
+constexpr std::vector<uint64_t> factor(uint64_t n) {
+    std::vector<uint64_t> ret;
+    factor(n, ret);
+    return ret;
+}
+
+// the prime factors of n > 0 with their exponents
+inline std::map<uint64_t, size_t> factor_map(uint64_t n) {
+    std::map<uint64_t, size_t> ret;
+    for (uint64_t p : factor(n)) ++ret[p];
+    return ret;
+}
+
+// the factors of values[i] are factors[offsets[i]] until factors[offsets[i + 1]]
+struct factorization {
+    std::vector<uint64_t> factors;
+    std::vector<size_t> offsets;
+
+    std::span<uint64_t const> operator[](size_t i) const {
+        return std::span<uint64_t const>(factors).subspan(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
+// the factorizations of all the values in one flat vector
+inline factorization factor(std::span<uint64_t const> values) {
+    factorization ret;
+    ret.offsets.reserve(values.size() + 1);
+    // a 64-bit number has 15 distinct prime factors at most, and about 4 with multiplicity on average
+    ret.factors.reserve(values.size() * 4);
+    ret.offsets.push_back(0);
+    for (uint64_t n : values) {
+        factor(n, ret.factors);
+        ret.offsets.push_back(ret.factors.size());
+    }
+    return ret;
+}
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#include "factor.cpp"
+
+#include <iostream>
+
+// the largest 64-bit number, a square of a prime past 2^31 and a product of two such primes
+static_assert(yao_math::factor(18446744073709551615u) == std::vector<uint64_t>{3, 5, 17, 257, 641, 65537, 6700417});
+static_assert(yao_math::factor(4294967291ull * 4294967291ull) == std::vector<uint64_t>{4294967291, 4294967291});
+static_assert(yao_math::factor(4294967279ull * 4294967291ull) == std::vector<uint64_t>{4294967279, 4294967291});
+static_assert(yao_math::factor(1031ull * 1031 * 1031 * 2) == std::vector<uint64_t>{2, 1031, 1031, 1031});
+static_assert(yao_math::factor(18446744073709551557u) == std::vector<uint64_t>{18446744073709551557u});
+// SQUFOF alone on a product of two 24-bit primes
+static_assert(yao_math::factoring::squfof(16777213ull * 16777199ull) % 16777199u == 0);
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    vector<uint64_t> values = {1, 600851475143, 1000000016000000063, 9223372036854775807};
+    auto result = factor(values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        cout << values[i] << " =";
+        for (uint64_t p : result[i]) cout << ' ' << p;
+        cout << endl;
+    }
+    for (auto [p, e] : factor_map(1ull << 40 | 1)) cout << p << '^' << e << ' ';
+    cout << endl;
+}
@@ -1,60 +1,206 @@
 #include <limits>
 #include <type_traits>
+#include <cstdint>
 #include <bit>
 
+#ifndef YAO_MATH_FPBITS
+#define YAO_MATH_FPBITS
+
 namespace yao_math {
 
-typedef unsigned long long bitfield;
+typedef unsigned __int128 bitfield;
 
 /*
- * helper class to construct/destruct a floating-point number
- * with the assumption that
- * - float and double meet IEEE 754
- * - native endianness is little-endian
+ * the layout of the IEEE 754 binary formats, from the top:
+ *   sign (1 bit) | biased exponent (EXPONENT bits) | [leading one] | fraction (FRACTION bits)
+ * the leading one is stored only by the x87 extended format
 */
 
-static_assert(std::numeric_limits<float>::is_iec559);
-static_assert(std::numeric_limits<double>::is_iec559);
-static_assert(std::endian::little == std::endian::native);
+template<int DIGITS_, int EXPONENT_, bool EXPLICIT_LEADING_, typename Storage>
+struct fp_format {
+    using storage_type = Storage;
+    constexpr static int DIGITS = DIGITS_;
+    constexpr static int EXPONENT = EXPONENT_;
+    constexpr static bool EXPLICIT_LEADING = EXPLICIT_LEADING_;
+};
+
+using binary32 = fp_format<24, 8, false, std::uint32_t>;
+using binary64 = fp_format<53, 11, false, std::uint64_t>;
+using x87_extended = fp_format<64, 15, true, unsigned __int128>;
+using binary128 = fp_format<113, 15, false, unsigned __int128>;
+
+// the extended types (__float128, _Float32, std::float128_t...) go by their size
+template<typename F>
+struct fp_format_of : std::conditional_t<sizeof(F) == 4, binary32, std::conditional_t<sizeof(F) == 8, binary64, binary128>> {
+    static_assert(std::is_floating_point_v<F> && (sizeof(F) == 4 || sizeof(F) == 8 || sizeof(F) == 16),
+                  "not an IEEE 754 binary format");
+};
+
+template<>
+struct fp_format_of<float> : binary32 {
+    static_assert(std::numeric_limits<float>::is_iec559);
+};
+
+template<>
+struct fp_format_of<double> : binary64 {
+    static_assert(std::numeric_limits<double>::is_iec559);
+};
+
+// long double is double, x87 extended or quadruple precision depending on the platform
+template<>
+struct fp_format_of<long double> : std::conditional_t<std::numeric_limits<long double>::digits == 53, binary64,
+                                   std::conditional_t<std::numeric_limits<long double>::digits == 64, x87_extended, binary128>> {
+    static_assert(std::numeric_limits<long double>::digits == 53 || std::numeric_limits<long double>::digits == 64
+                  || std::numeric_limits<long double>::digits == 113, "unknown long double format");
+};
+
+/*
+ * helper class to construct/destruct a floating-point number
+ * through std::bit_cast, so that it works in constant expressions
+*/
 
 template<typename F>
 struct FPBits {
-    static_assert(std::is_same_v<F, float> || std::is_same_v<F, double>, "only float and double is supported");
-    constexpr static int FRACTION = std::numeric_limits<F>::digits - 1;
-    constexpr static int EXPONENT = (sizeof(F) << 3) - FRACTION - 1;
-    constexpr static int EXPONENT_OFFSET = std::numeric_limits<F>::max_exponent - 1;
-    bitfield fraction: FRACTION;
-    bitfield exponent: EXPONENT;
-    bitfield sign: 1;
-    FPBits(F value = 0) {
-        *(F*)this = value;
+    using format = fp_format_of<F>;
+    using storage_type = typename format::storage_type;
+    // the number of bits after the leading one
+    constexpr static int FRACTION = format::DIGITS - 1;
+    constexpr static int EXPONENT = format::EXPONENT;
+    constexpr static int EXPONENT_OFFSET = (1 << (EXPONENT - 1)) - 1;
+    constexpr static bool EXPLICIT_LEADING = format::EXPLICIT_LEADING;
+    constexpr static int SIGNIFICAND = FRACTION + EXPLICIT_LEADING;
+    constexpr static unsigned EXPONENT_MAX = (1u << EXPONENT) - 1;
+    constexpr static storage_type FRACTION_MASK = (storage_type(1) << FRACTION) - 1;
+    constexpr static storage_type LEADING = storage_type(1) << FRACTION;
+
+    storage_type bits;
+
+    constexpr FPBits(F value = 0) noexcept : bits(to_bits(value)) {}
+
+    constexpr operator F() const noexcept {
+        return from_bits(bits);
     }
-    operator F() const {
-        return *(F*)this;
+
+    constexpr bool sign() const noexcept {
+        return (bits >> (SIGNIFICAND + EXPONENT)) & 1;
     }
-    
-    // impl note: log2 is inappropriate for subnormal floating point
-    int log2() const {
-        return exponent - EXPONENT_OFFSET;
+    constexpr unsigned exponent() const noexcept {
+        return unsigned(bits >> SIGNIFICAND) & EXPONENT_MAX;
     }
-    void exp2(int n) {
-        exponent = EXPONENT_OFFSET + n;
+    constexpr storage_type fraction() const noexcept {
+        return bits & FRACTION_MASK;
     }
 
-    // returns the fraction with leading one
-    bitfield full_fraction() const {
-        return fraction | (bitfield(1) << FRACTION);
+    constexpr bool is_zero() const noexcept {
+        return !exponent() && !fraction();
+    }
+    constexpr bool is_subnormal() const noexcept {
+        return !exponent() && fraction();
+    }
+    constexpr bool is_inf() const noexcept {
+        return exponent() == EXPONENT_MAX && !fraction();
+    }
+    constexpr bool is_nan() const noexcept {
+        return exponent() == EXPONENT_MAX && fraction();
+    }
+    constexpr bool is_finite() const noexcept {
+        return exponent() != EXPONENT_MAX;
+    }
+
+    // the exponent of the leading one, for normal numbers only
+    constexpr int log2() const noexcept {
+        return int(exponent()) - EXPONENT_OFFSET;
+    }
+
+    // returns the fraction with leading one, which subnormal numbers lack
+    constexpr storage_type full_fraction() const noexcept {
+        return exponent() ? fraction() | LEADING : fraction();
     }
     // returns the exponent without fraction
-    int partial_log2() const {
-        return log2() - FRACTION;
+    constexpr int partial_log2() const noexcept {
+        return (exponent() ? log2() : 1 - EXPONENT_OFFSET) - FRACTION;
     }
-    
-    // based on the two functions above, 
-    // the value of the floating point is equivalent to
+
+    // based on the two functions above,
+    // the value of a finite floating point is equivalent to
     //       full_fraction() << +partial_log2()
     //   or  full_fraction() >> -partial_log2()
     // in integral semantics
+
+    static constexpr F inf(bool negative = false) noexcept {
+        return compose_bits(negative, EXPONENT_MAX, EXPLICIT_LEADING ? LEADING : 0);
+    }
+    static constexpr F quiet_nan() noexcept {
+        return compose_bits(false, EXPONENT_MAX, (EXPLICIT_LEADING ? LEADING : 0) | LEADING >> 1);
+    }
+
+    /*
+     * rounds (window + sticky) * 2^(log2 - 127) to nearest, ties to even,
+     * where the top bit of window is set and sticky stands for the nonzero bits below it
+     * goes to subnormal numbers, zero or infinity when log2 is out of range
+    */
+    static constexpr F compose(bool negative, bitfield window, int log2, bool sticky = false) noexcept {
+        constexpr int DIGITS = FRACTION + 1;
+        constexpr int MIN_LOG2 = 1 - EXPONENT_OFFSET;
+        if (log2 > EXPONENT_OFFSET) return inf(negative);
+        // subnormal numbers keep fewer digits
+        int keep = log2 >= MIN_LOG2 ? DIGITS : DIGITS - (MIN_LOG2 - log2);
+        bitfield mantissa, rest;
+        if (keep > 0) {
+            mantissa = window >> (128 - keep);
+            rest = window << keep;
+        } else {
+            mantissa = 0;
+            sticky |= keep < 0 && window;
+            rest = keep < 0 ? 0 : window;
+        }
+        constexpr bitfield HALF = bitfield(1) << 127;
+        if (rest > HALF || (rest == HALF && (sticky || (mantissa & 1)))) ++mantissa;
+        // the carry of rounding turns 1.11..1 into 10.00..0, and the biggest subnormal into the smallest normal
+        unsigned biased = log2 >= MIN_LOG2 ? unsigned(log2 + EXPONENT_OFFSET) : 0;
+        if (mantissa >> DIGITS) {
+            mantissa >>= 1;
+            ++biased;
+        } else if (!biased && mantissa >> FRACTION) {
+            biased = 1;
+        }
+        if (biased >= EXPONENT_MAX) return inf(negative);
+        return compose_bits(negative, biased, EXPLICIT_LEADING ? storage_type(mantissa) : storage_type(mantissa) & FRACTION_MASK);
+    }
+
+private:
+    static constexpr F compose_bits(bool negative, unsigned exponent, storage_type significand) noexcept {
+        return from_bits(storage_type(negative) << (SIGNIFICAND + EXPONENT) | storage_type(exponent) << SIGNIFICAND | significand);
+    }
+
+    // the x87 format leaves 6 padding bytes, which must not be read as part of an integer
+    struct x87_layout {
+        std::uint64_t significand;
+        std::uint16_t sign_exponent;
+    };
+    struct x87_padded {
+        std::uint64_t significand;
+        std::uint16_t sign_exponent, padding[(sizeof(F) - 10) / 2];
+    };
+
+    static constexpr storage_type to_bits(F value) noexcept {
+        if constexpr (std::is_base_of_v<x87_extended, format> && sizeof(F) > 10) {
+            auto layout = std::bit_cast<x87_layout>(value);
+            return storage_type(layout.sign_exponent) << 64 | layout.significand;
+        } else {
+            return std::bit_cast<storage_type>(value);
+        }
+    }
+
+    static constexpr F from_bits(storage_type bits) noexcept {
+        if constexpr (std::is_base_of_v<x87_extended, format> && sizeof(F) > 10) {
+            return std::bit_cast<F>(x87_padded{std::uint64_t(bits), std::uint16_t(bits >> 64), {}});
+        } else {
+            return std::bit_cast<F>(bits);
+        }
+    }
 };
 
-}
\ No newline at end of file
+}
+
+#endif
@@ -1,6 +1,9 @@
 #include <stdexcept>
 #include <cstdint>
 
+#ifndef YAO_MATH_INT_BASE
+#define YAO_MATH_INT_BASE
+
 namespace yao_math::int_base {
 	constexpr int min = 2, bin = 2, oct = 8, dec = 10, hex = 16, max = 36;
 	constexpr bool isInvalid(int base) { 
@@ -33,4 +36,6 @@ namespace yao_math::int_base {
 		if (num < 0 || num >= base) throw std::invalid_argument("invalid num");
 		return to_char_raw(num, base, uppercase);
 	}
-}
\ No newline at end of file
+}
+
+#endif
@@ -49,12 +49,33 @@ struct Arguments {
 	}
 };
 
+template<unsigned Base>
+std::uintmax_t next_digit(std::uintmax_t& in) {
+	std::uintmax_t bit = in % Base;
+	in /= Base;
+	return bit;
+}
+
 template<typename Iter, typename CharT>
 void raw(Iter last, std::uintmax_t in, int base, CharT zero, CharT A) {
-	if (in == 0)
-		*--last = zero;
-	else for (size_t bit; in > 0; in /= base) bit = in % base,
-		*--last = CharT(bit + (bit < 10 ? zero : A - 10));
+	auto digits = [&](auto next) {
+		do {
+			std::uintmax_t bit = next(in);
+			*--last = CharT(bit + (bit < 10 ? zero : A - 10));
+		} while (in > 0);
+	};
+	// 常用进制的除数是常量, 编译器会换成乘法和移位
+	switch (base) {
+		case 2: digits(next_digit<2>); break;
+		case 8: digits(next_digit<8>); break;
+		case 10: digits(next_digit<10>); break;
+		case 16: digits(next_digit<16>); break;
+		default: digits([base](std::uintmax_t& in) {
+			std::uintmax_t bit = in % base;
+			in /= base;
+			return bit;
+		});
+	}
 }
 
 template<bool Signed>
@@ -0,0 +1,930 @@
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <bit>
+#include <algorithm>
+#include <random>
+
+#ifndef YAO_MATH_LIMB
+#define YAO_MATH_LIMB
+
+/*
+ * low-level kernels working on little-endian arrays of limbs,
+ * which are the building blocks of wide_int and friends
+ *
+ * all of them are constexpr and accept any unsigned limb type,
+ * but they are tuned for 64-bit limbs
+ */
+
+namespace yao_math::limb {
+
+// the widest limb type whose width divides N
+template<size_t N>
+using limb_for = std::conditional_t<N % 64 == 0, std::uint64_t,
+                 std::conditional_t<N % 32 == 0, std::uint32_t,
+                 std::conditional_t<N % 16 == 0, std::uint16_t, std::uint8_t>>>;
+
+template<typename L>
+constexpr size_t bits = sizeof(L) << 3;
+
+// returns a + b + carry and sets carry to the carry out
+template<typename L>
+constexpr L addc(L a, L b, L& carry) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    L s;
+    bool c1 = __builtin_add_overflow(a, b, &s);
+    bool c2 = __builtin_add_overflow(s, carry, &s);
+    carry = c1 | c2;
+    return s;
+#else
+    L s = a + b;
+    L c1 = s < a;
+    s += carry;
+    carry = c1 | (s < carry);
+    return s;
+#endif
+}
+
+// returns a - b - borrow and sets borrow to the borrow out
+template<typename L>
+constexpr L subb(L a, L b, L& borrow) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    L d;
+    bool b1 = __builtin_sub_overflow(a, b, &d);
+    bool b2 = __builtin_sub_overflow(d, borrow, &d);
+    borrow = b1 | b2;
+    return d;
+#else
+    L d = a - b;
+    L b1 = a < b;
+    L b2 = d < borrow;
+    d -= borrow;
+    borrow = b1 | b2;
+    return d;
+#endif
+}
+
+// returns the low half of a * b and sets hi to the high half
+template<typename L>
+constexpr L mul_wide(L a, L b, L& hi) noexcept {
+    if constexpr (sizeof(L) < sizeof(std::uint64_t)) {
+        std::uint64_t p = std::uint64_t(a) * b;
+        hi = L(p >> bits<L>);
+        return L(p);
+    } else {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 p = (unsigned __int128) a * b;
+        hi = L(p >> 64);
+        return L(p);
+#else
+        std::uint64_t a0 = std::uint32_t(a), a1 = a >> 32;
+        std::uint64_t b0 = std::uint32_t(b), b1 = b >> 32;
+        std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        std::uint64_t mid = (p00 >> 32) + std::uint32_t(p01) + std::uint32_t(p10);
+        hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+        return (mid << 32) | std::uint32_t(p00);
+#endif
+    }
+}
+
+template<typename L>
+constexpr void copy_n(L* r, const L* a, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) r[i] = a[i];
+}
+
+template<typename L>
+constexpr void zero_n(L* r, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) r[i] = 0;
+}
+
+// r = a + b, returns the carry out
+template<typename L>
+constexpr L add_n(L* r, const L* a, const L* b, size_t n) noexcept {
+    L carry = 0;
+    for (size_t i = 0; i < n; ++i) r[i] = addc(a[i], b[i], carry);
+    return carry;
+}
+
+// r = a - b, returns the borrow out
+template<typename L>
+constexpr L sub_n(L* r, const L* a, const L* b, size_t n) noexcept {
+    L borrow = 0;
+    for (size_t i = 0; i < n; ++i) r[i] = subb(a[i], b[i], borrow);
+    return borrow;
+}
+
+// r = a + b where b is a single limb, returns the carry out
+template<typename L>
+constexpr L add_1(L* r, const L* a, size_t n, L b) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        L ai = a[i];
+        r[i] = ai + b;
+        if (r[i] >= ai) {
+            if (r != a) for (++i; i < n; ++i) r[i] = a[i];
+            return 0;
+        }
+        b = 1;
+    }
+    return b;
+}
+
+// r = a - b where b is a single limb, returns the borrow out
+template<typename L>
+constexpr L sub_1(L* r, const L* a, size_t n, L b) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        L ai = a[i];
+        r[i] = ai - b;
+        if (ai >= b) {
+            if (r != a) for (++i; i < n; ++i) r[i] = a[i];
+            return 0;
+        }
+        b = 1;
+    }
+    return b;
+}
+
+// r = -a in two's complement, returns whether a is nonzero
+template<typename L>
+constexpr L neg_n(L* r, const L* a, size_t n) noexcept {
+    L borrow = 0;
+    for (size_t i = 0; i < n; ++i) r[i] = subb(L(0), a[i], borrow);
+    return borrow;
+}
+
+// r += a where an <= rn, returns the carry out
+template<typename L>
+constexpr L add_to(L* r, size_t rn, const L* a, size_t an) noexcept {
+    L carry = add_n(r, r, a, an);
+    return carry ? add_1(r + an, r + an, rn - an, carry) : 0;
+}
+
+// r -= a where an <= rn, returns the borrow out
+template<typename L>
+constexpr L sub_from(L* r, size_t rn, const L* a, size_t an) noexcept {
+    L borrow = sub_n(r, r, a, an);
+    return borrow ? sub_1(r + an, r + an, rn - an, borrow) : 0;
+}
+
+// compares a and b as unsigned numbers
+template<typename L>
+constexpr int cmp_n(const L* a, const L* b, size_t n) noexcept {
+    for (size_t i = n - 1; /* i >= 0 */ ~i; --i) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// compares a and b as unsigned numbers where an >= bn
+template<typename L>
+constexpr int cmp(const L* a, size_t an, const L* b, size_t bn) noexcept {
+    for (size_t i = an - 1; i >= bn && /* i >= 0 */ ~i; --i) {
+        if (a[i]) return 1;
+    }
+    return cmp_n(a, b, bn);
+}
+
+// r = |a - b| where an >= bn, returns whether a < b
+template<typename L>
+constexpr bool abs_diff(L* r, const L* a, size_t an, const L* b, size_t bn) noexcept {
+    if (cmp(a, an, b, bn) >= 0) {
+        L borrow = sub_n(r, a, b, bn);
+        sub_1(r + bn, a + bn, an - bn, borrow);
+        return false;
+    } else {
+        sub_n(r, b, a, bn);
+        zero_n(r + bn, an - bn);
+        return true;
+    }
+}
+
+// r = a << cnt where 0 < cnt < bits<L>, returns the bits shifted out
+template<typename L>
+constexpr L lshift(L* r, const L* a, size_t n, unsigned cnt) noexcept {
+    L out = a[n - 1] >> (bits<L> - cnt);
+    for (size_t i = n - 1; i > 0; --i) {
+        r[i] = (a[i] << cnt) | (a[i - 1] >> (bits<L> - cnt));
+    }
+    r[0] = a[0] << cnt;
+    return out;
+}
+
+// r = a >> cnt where 0 < cnt < bits<L>, the vacated bits are taken from fill
+template<typename L>
+constexpr void rshift(L* r, const L* a, size_t n, unsigned cnt, L fill = 0) noexcept {
+    for (size_t i = 0; i + 1 < n; ++i) {
+        r[i] = (a[i] >> cnt) | (a[i + 1] << (bits<L> - cnt));
+    }
+    r[n - 1] = (a[n - 1] >> cnt) | (fill << (bits<L> - cnt));
+}
+
+// r = a << cnt for any cnt, the vacated limbs are zero; r may be a
+template<typename L>
+constexpr void shift_left(L* r, const L* a, size_t n, size_t cnt) noexcept {
+    size_t words = std::min(cnt / bits<L>, n);
+    unsigned rest = cnt % bits<L>;
+    if (words < n) {
+        if (rest) lshift(r + words, a, n - words, rest);
+        else for (size_t i = n - words; i--; ) r[i + words] = a[i];
+    }
+    zero_n(r, words);
+}
+
+// r = a >> cnt for any cnt, the vacated limbs are taken from fill; r may be a
+template<typename L>
+constexpr void shift_right(L* r, const L* a, size_t n, size_t cnt, L fill = 0) noexcept {
+    size_t words = std::min(cnt / bits<L>, n);
+    unsigned rest = cnt % bits<L>;
+    if (words < n) {
+        if (rest) rshift(r, a + words, n - words, rest, fill);
+        else for (size_t i = 0; i < n - words; ++i) r[i] = a[i + words];
+    }
+    for (size_t i = n - words; i < n; ++i) r[i] = fill;
+}
+
+// the number of leading zero bits of a, n * bits<L> if it is 0
+template<typename L>
+constexpr size_t countl_zero(const L* a, size_t n) noexcept {
+    for (size_t i = n; i--; ) {
+        if (a[i]) return (n - 1 - i) * bits<L> + std::countl_zero(a[i]);
+    }
+    return n * bits<L>;
+}
+
+// the number of trailing zero bits of a, n * bits<L> if it is 0
+template<typename L>
+constexpr size_t countr_zero(const L* a, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i]) return i * bits<L> + std::countr_zero(a[i]);
+    }
+    return n * bits<L>;
+}
+
+template<typename L>
+constexpr size_t popcount(const L* a, size_t n) noexcept {
+    size_t ret = 0;
+    for (size_t i = 0; i < n; ++i) ret += std::popcount(a[i]);
+    return ret;
+}
+
+// the number of bits up to the highest set one, 0 if a is 0
+template<typename L>
+constexpr size_t bit_width(const L* a, size_t n) noexcept {
+    return n * bits<L> - countl_zero(a, n);
+}
+
+// r = a * b where b is a single limb, returns the high limb
+template<typename L>
+constexpr L mul_1(L* r, const L* a, size_t n, L b) noexcept {
+    L carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        L hi, c = 0;
+        L lo = mul_wide(a[i], b, hi);
+        r[i] = addc(lo, carry, c);
+        carry = hi + c;
+    }
+    return carry;
+}
+
+// r += a * b where b is a single limb, returns the high limb
+template<typename L>
+constexpr L addmul_1(L* r, const L* a, size_t n, L b) noexcept {
+    L carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        L hi, c1 = 0, c2 = 0;
+        L lo = mul_wide(a[i], b, hi);
+        lo = addc(lo, carry, c1);
+        r[i] = addc(r[i], lo, c2);
+        carry = hi + c1 + c2;
+    }
+    return carry;
+}
+
+// r = a / 3 in two's complement, where a must be a multiple of 3
+template<typename L>
+constexpr void divexact_by3(L* r, const L* a, size_t n) noexcept {
+    constexpr L inverse = L(~L(0) / 3 * 2 + 1); // 3 * inverse == 1 (mod 2^bits)
+    L carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        L borrow = 0;
+        L d = subb(a[i], carry, borrow);
+        L q = L(std::uint64_t(d) * inverse);
+        L hi;
+        mul_wide(q, L(3), hi);
+        r[i] = q;
+        carry = hi + borrow;
+    }
+}
+
+// r -= a * b where b is a single limb, returns the high limb of the borrow
+template<typename L>
+constexpr L submul_1(L* r, const L* a, size_t n, L b) noexcept {
+    L carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        L hi, c = 0, borrow = 0;
+        L lo = mul_wide(a[i], b, hi);
+        lo = addc(lo, carry, c);
+        r[i] = subb(r[i], lo, borrow);
+        carry = hi + c + borrow;
+    }
+    return carry;
+}
+
+/*
+ * division by invariant integers, following
+ * Moller & Granlund, "Improved division by invariant integers" (2011)
+ *
+ * a normalized divisor d has its highest bit set,
+ * its reciprocal is floor((B^2 - 1) / d) - B where B = 2^bits<L>
+ */
+
+template<typename L>
+constexpr L reciprocal(L d) noexcept {
+    if constexpr (sizeof(L) < sizeof(std::uint64_t)) {
+        constexpr std::uint64_t B = std::uint64_t(1) << bits<L>;
+        return L((B * B - 1) / d - B);
+    } else {
+#ifdef __SIZEOF_INT128__
+        return L(~(unsigned __int128) 0 / d);
+#else
+        // restoring division of B^2 - 1 by d, dropping the leading 1 of the quotient
+        L q = 0, r = ~d;
+        for (size_t i = 0; i < bits<L>; ++i) {
+            bool top = r >> (bits<L> - 1);
+            r = (r << 1) | 1;
+            q <<= 1;
+            if (top || r >= d) {
+                r -= d;
+                q |= 1;
+            }
+        }
+        return q;
+#endif
+    }
+}
+
+// divides (u1, u0) by the normalized d with reciprocal v where u1 < d, returns the quotient
+template<typename L>
+constexpr L div_2by1(L u1, L u0, L d, L v, L& r) noexcept {
+    L q1, c = 0;
+    L q0 = mul_wide(v, u1, q1);
+    q0 = addc(q0, u0, c);
+    q1 = q1 + u1 + 1 + c;
+    r = u0 - q1 * d;
+    if (r > q0) {
+        --q1;
+        r += d;
+    }
+    if (r >= d) {
+        ++q1;
+        r -= d;
+    }
+    return q1;
+}
+
+// a single nonzero limb divisor, normalized together with its reciprocal to divide by it many times
+template<typename L>
+struct inverse {
+    L d, v;
+    unsigned shift;
+
+    constexpr explicit inverse(L divisor) noexcept :
+        d(L(divisor << std::countl_zero(divisor))), v(reciprocal(d)), shift(std::countl_zero(divisor)) {}
+};
+
+// q = a / d where d is a single nonzero limb, returns the remainder, q may alias a
+template<typename L>
+constexpr L divrem_1(L* q, const L* a, size_t n, inverse<L> const& d) noexcept {
+    unsigned shift = d.shift;
+    L r = 0;
+    if (shift) r = a[n - 1] >> (bits<L> - shift);
+    for (size_t i = n - 1; /* i >= 0 */ ~i; --i) {
+        L u = a[i] << shift;
+        if (shift && i) u |= a[i - 1] >> (bits<L> - shift);
+        q[i] = div_2by1(r, u, d.d, d.v, r);
+    }
+    return r >> shift;
+}
+
+template<typename L>
+constexpr L divrem_1(L* q, const L* a, size_t n, L d) noexcept {
+    return divrem_1(q, a, n, inverse<L>(d));
+}
+
+// a % d where d is a single nonzero limb
+template<typename L>
+constexpr L mod_1(const L* a, size_t n, inverse<L> const& d) noexcept {
+    unsigned shift = d.shift;
+    L r = 0;
+    if (shift) r = a[n - 1] >> (bits<L> - shift);
+    for (size_t i = n - 1; /* i >= 0 */ ~i; --i) {
+        L u = a[i] << shift;
+        if (shift && i) u |= a[i - 1] >> (bits<L> - shift);
+        div_2by1(r, u, d.d, d.v, r);
+    }
+    return r >> shift;
+}
+
+constexpr size_t divrem_scratch(size_t an, size_t dn) noexcept {
+    return an + 1 + dn;
+}
+
+/*
+ * the loop of Algorithm D below, for divisors normalized ahead of time
+ * q = u / v with an - dn + 1 limbs, where u has an + 1 limbs and is left with the remainder,
+ * v has dn > 1 limbs with the highest bit set and inv = reciprocal(v[dn - 1])
+ */
+template<typename L>
+constexpr void divrem_normalized(L* q, L* u, size_t an, const L* v, size_t dn, L inv) noexcept {
+    L d1 = v[dn - 1], d0 = v[dn - 2];
+    for (size_t j = an - dn; /* j >= 0 */ ~j; --j) {
+        L u2 = u[j + dn], u1 = u[j + dn - 1], u0 = u[j + dn - 2];
+        L qhat, rhat;
+        bool overflow = false;
+        if (u2 == d1) {
+            qhat = ~L(0);
+            rhat = u1 + d1;
+            overflow = rhat < u1;
+        } else {
+            qhat = div_2by1(u2, u1, d1, inv, rhat);
+        }
+        // qhat is now at most 2 too large, the second divisor limb settles it to at most 1
+        while (!overflow) {
+            L hi, lo = mul_wide(qhat, d0, hi);
+            if (hi < rhat || (hi == rhat && lo <= u0)) break;
+            --qhat;
+            rhat += d1;
+            overflow = rhat < d1;
+        }
+        L borrow = submul_1(u + j, v, dn, qhat);
+        L top = u[j + dn];
+        u[j + dn] = top - borrow;
+        if (top < borrow) {
+            --qhat;
+            u[j + dn] += add_n(u + j, u + j, v, dn);
+        }
+        q[j] = qhat;
+    }
+}
+
+/*
+ * long division by Knuth's Algorithm D, TAOCP Vol. 2, 4.3.1
+ * q = a / d with an - dn + 1 limbs, r = a % d with dn limbs,
+ * where an >= dn > 0 and the highest limb of d is nonzero
+ */
+template<typename L>
+constexpr void divrem(L* q, L* r, const L* a, size_t an, const L* d, size_t dn, L* scratch) noexcept {
+    if (dn == 1) {
+        r[0] = divrem_1(q, a, an, d[0]);
+        return;
+    }
+    L* u = scratch;
+    L* v = u + an + 1;
+    unsigned shift = std::countl_zero(d[dn - 1]);
+    if (shift) {
+        lshift(v, d, dn, shift);
+        u[an] = lshift(u, a, an, shift);
+    } else {
+        copy_n(v, d, dn);
+        copy_n(u, a, an);
+        u[an] = 0;
+    }
+    divrem_normalized(q, u, an, v, dn, reciprocal(v[dn - 1]));
+    if (shift) rshift(r, u, dn, shift);
+    else copy_n(r, u, dn);
+}
+
+// r = a * b in full where an >= bn > 0, r must not overlap a or b
+template<typename L>
+constexpr void mul_basecase(L* r, const L* a, size_t an, const L* b, size_t bn) noexcept {
+    r[an] = mul_1(r, a, an, b[0]);
+    for (size_t i = 1; i < bn; ++i) {
+        r[an + i] = addmul_1(r + i, a, an, b[i]);
+    }
+}
+
+// r = the low n limbs of a * b, r must not overlap a or b
+template<typename L>
+constexpr void mullo_basecase(L* r, const L* a, const L* b, size_t n) noexcept {
+    mul_1(r, a, n, b[0]);
+    for (size_t i = 1; i < n; ++i) {
+        addmul_1(r + i, a, n - i, b[i]);
+    }
+}
+
+/*
+ * multiplication of two n-limb numbers is dispatched by size:
+ * - schoolbook below KARATSUBA_THRESHOLD limbs
+ * - Karatsuba below TOOM3_THRESHOLD limbs
+ * - Toom-3 above
+ * the thresholds are tuned on x86-64, where Toom-3 only pays off beyond
+ * the widths of the wide_int aliases
+ *
+ * the recursive algorithms take their temporaries from a caller-provided
+ * scratch area of mul_scratch(n) limbs, so they work in constant expressions
+ */
+
+constexpr size_t KARATSUBA_THRESHOLD = 24;
+constexpr size_t TOOM3_THRESHOLD = 384;
+constexpr size_t MULLO_THRESHOLD = 48;
+
+constexpr size_t mul_scratch(size_t n) noexcept {
+    if (n < KARATSUBA_THRESHOLD) return 0;
+    if (n < TOOM3_THRESHOLD) {
+        size_t h = (n + 1) / 2;
+        return 6 * h + 1 + mul_scratch(h);
+    }
+    size_t k = (n + 2) / 3;
+    return 16 * k + 22 + mul_scratch(k + 1);
+}
+
+constexpr size_t mullo_scratch(size_t n) noexcept {
+    if (n < MULLO_THRESHOLD) return 0;
+    size_t l = n / 2, h = n - l;
+    return 2 * h + l + std::max(mul_scratch(h), mullo_scratch(l));
+}
+
+template<typename L>
+constexpr void mul_n(L* r, const L* a, const L* b, size_t n, L* scratch) noexcept;
+
+template<typename L>
+constexpr void karatsuba(L* r, const L* a, const L* b, size_t n, L* scratch) noexcept {
+    size_t h = (n + 1) / 2, l = n - h;
+    L* da = scratch;
+    L* db = da + h;
+    L* z1 = db + h;
+    L* t = z1 + 2 * h;
+    L* next = t + 2 * h + 1;
+    bool sa = abs_diff(da, a, h, a + h, l);
+    bool sb = abs_diff(db, b, h, b + h, l);
+    mul_n(r, a, b, h, next);
+    mul_n(r + 2 * h, a + h, b + h, l, next);
+    mul_n(z1, da, db, h, next);
+    // t = a0 * b1 + a1 * b0 = z0 + z2 - (a0 - a1) * (b0 - b1)
+    copy_n(t, r, 2 * h);
+    t[2 * h] = add_to(t, 2 * h, r + 2 * h, 2 * l);
+    if (sa == sb) sub_from(t, 2 * h + 1, z1, 2 * h);
+    else add_to(t, 2 * h + 1, z1, 2 * h);
+    add_to(r + h, 2 * n - h, t, std::min(2 * h + 1, 2 * n - h));
+}
+
+template<typename L>
+constexpr void toom3(L* r, const L* a, const L* b, size_t n, L* scratch) noexcept {
+    // evaluate at 0, 1, -1, -2 and infinity, then interpolate by Bodrato's sequence
+    size_t k = (n + 2) / 3, s = n - 2 * k;
+    size_t e = k + 2, w = 2 * k + 2;
+    L* ea1 = scratch;
+    L* eam1 = ea1 + e;
+    L* eam2 = eam1 + e;
+    L* eb1 = eam2 + e;
+    L* ebm1 = eb1 + e;
+    L* ebm2 = ebm1 + e;
+    L* v0 = ebm2 + e;
+    L* v1 = v0 + w;
+    L* vm1 = v1 + w;
+    L* vm2 = vm1 + w;
+    L* vinf = vm2 + w;
+    L* next = vinf + w;
+    auto evaluate = [k, s, e](const L* x, L* p1, L* pm1, L* pm2) {
+        // p1 = x0 + x1 + x2, pm1 = x0 - x1 + x2, pm2 = x0 - 2 x1 + 4 x2 in two's complement
+        copy_n(pm1, x, k);
+        zero_n(pm1 + k, e - k);
+        add_to(pm1, e, x + 2 * k, s);
+        copy_n(p1, pm1, e);
+        add_to(p1, e, x + k, k);
+        sub_from(pm1, e, x + k, k);
+        copy_n(pm2, pm1, e);
+        add_to(pm2, e, x + 2 * k, s);
+        lshift(pm2, pm2, e, 1);
+        sub_from(pm2, e, x, k);
+    };
+    auto magnitude = [e](L* p) {
+        bool neg = p[e - 1] >> (bits<L> - 1);
+        if (neg) neg_n(p, p, e);
+        return neg;
+    };
+    evaluate(a, ea1, eam1, eam2);
+    evaluate(b, eb1, ebm1, ebm2);
+    bool sm1 = magnitude(eam1) != magnitude(ebm1);
+    bool sm2 = magnitude(eam2) != magnitude(ebm2);
+    mul_n(v1, ea1, eb1, k + 1, next);
+    mul_n(vm1, eam1, ebm1, k + 1, next);
+    mul_n(vm2, eam2, ebm2, k + 1, next);
+    if (sm1) neg_n(vm1, vm1, w);
+    if (sm2) neg_n(vm2, vm2, w);
+    mul_n(r, a, b, k, next);
+    mul_n(r + 4 * k, a + 2 * k, b + 2 * k, s, next);
+    copy_n(v0, r, 2 * k);
+    zero_n(v0 + 2 * k, w - 2 * k);
+    copy_n(vinf, r + 4 * k, 2 * s);
+    zero_n(vinf + 2 * s, w - 2 * s);
+    auto half = [w](L* x) {
+        rshift(x, x, w, 1, L(x[w - 1] >> (bits<L> - 1) ? ~L(0) : 0));
+    };
+    L* r3 = vm2;
+    L* r1 = v1;
+    L* r2 = vm1;
+    sub_n(r3, vm2, v1, w);      // r3 = (r(-2) - r(1)) / 3
+    divexact_by3(r3, r3, w);
+    sub_n(r1, v1, vm1, w);      // r1 = (r(1) - r(-1)) / 2
+    half(r1);
+    sub_n(r2, vm1, v0, w);      // r2 = r(-1) - r(0)
+    sub_n(r3, r2, r3, w);       // r3 = (r2 - r3) / 2 + 2 r(inf)
+    half(r3);
+    add_n(r3, r3, vinf, w);
+    add_n(r3, r3, vinf, w);
+    add_n(r2, r2, r1, w);       // r2 = r2 + r1 - r(inf)
+    sub_n(r2, r2, vinf, w);
+    sub_n(r1, r1, r3, w);       // r1 = r1 - r3
+    zero_n(r + 2 * k, 2 * k);
+    add_to(r + k, 2 * n - k, r1, std::min(w, 2 * n - k));
+    add_to(r + 2 * k, 2 * n - 2 * k, r2, std::min(w, 2 * n - 2 * k));
+    add_to(r + 3 * k, 2 * n - 3 * k, r3, std::min(w, 2 * n - 3 * k));
+}
+
+// r = a * b in full, r must have 2n limbs and must not overlap a or b
+template<typename L>
+constexpr void mul_n(L* r, const L* a, const L* b, size_t n, L* scratch) noexcept {
+    if (n < KARATSUBA_THRESHOLD) mul_basecase(r, a, n, b, n);
+    else if (n < TOOM3_THRESHOLD) karatsuba(r, a, b, n, scratch);
+    else toom3(r, a, b, n, scratch);
+}
+
+// a piece of 2bn limbs and the balanced engine under it, or the last piece shorter than bn multiplied the other way around
+constexpr size_t mul_scratch(size_t an, size_t bn) noexcept {
+    if (bn < KARATSUBA_THRESHOLD) return 0;
+    size_t tail = an % bn;
+    return 2 * bn + std::max(mul_scratch(bn), tail ? mul_scratch(bn, tail) : 0);
+}
+
+// r = a * b in full where an >= bn > 0, r must not overlap a or b
+template<typename L>
+constexpr void mul(L* r, const L* a, size_t an, const L* b, size_t bn, L* scratch) noexcept {
+    if (bn < KARATSUBA_THRESHOLD) {
+        mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    // a is cut into pieces of bn limbs, each multiplied by the balanced engine
+    L* t = scratch;
+    L* next = t + 2 * bn;
+    mul_n(r, a, b, bn, next);
+    for (size_t i = bn; i < an; i += bn) {
+        size_t m = std::min(bn, an - i);
+        if (m == bn) mul_n(t, a + i, b, bn, next);
+        else mul(t, b, bn, a + i, m, next);
+        zero_n(r + i + bn, m);
+        add_to(r + i, bn + m, t, bn + m);
+    }
+}
+
+// r = the low n limbs of a * b, r must not overlap a or b
+template<typename L>
+constexpr void mullo_n(L* r, const L* a, const L* b, size_t n, L* scratch) noexcept {
+    if (n < MULLO_THRESHOLD) {
+        mullo_basecase(r, a, b, n);
+        return;
+    }
+    // a * b = a0 * b0 + (a1 * b0 + a0 * b1) << h, where only the low halves of the cross terms matter
+    size_t l = n / 2, h = n - l;
+    L* t = scratch;
+    L* u = t + 2 * h;
+    L* next = u + l;
+    mul_n(t, a, b, h, next);
+    copy_n(r, t, n);
+    mullo_n(u, a + h, b, l, next);
+    add_n(r + h, r + h, u, l);
+    mullo_n(u, a, b + h, l, next);
+    add_n(r + h, r + h, u, l);
+}
+
+
+// removes the trailing zero bits of a nonzero a in place, returns the significant limbs left
+template<typename L>
+constexpr size_t strip_twos(L* a, size_t n) noexcept {
+    size_t w = 0;
+    while (!a[w]) ++w;
+    unsigned cnt = std::countr_zero(a[w]);
+    if (w) {
+        for (size_t i = w; i < n; ++i) a[i - w] = a[i];
+        zero_n(a + n - w, w);
+        n -= w;
+    }
+    if (cnt) rshift(a, a, n, cnt);
+    // a difference of close numbers may have lost several top limbs
+    while (!a[n - 1]) --n;
+    return n;
+}
+
+// compares a and b of the significant limbs an and bn
+template<typename L>
+constexpr int cmp_sized(const L* a, size_t an, const L* b, size_t bn) noexcept {
+    if (an != bn) return an < bn ? -1 : 1;
+    return cmp_n(a, b, an);
+}
+
+// gcd of odd a and b
+template<typename L>
+constexpr L gcd_1(L a, L b) noexcept {
+    while (a != b) {
+        if (a < b) std::swap(a, b);
+        a -= b;
+        a >>= std::countr_zero(a);
+    }
+    return a;
+}
+
+/*
+ * r = gcd(a, b) by Stein's binary algorithm, where a and b are nonzero
+ * and trimmed, returns the significant limbs of r; a and b are destroyed
+ */
+template<typename L>
+constexpr size_t gcd_binary(L* r, L* a, size_t an, L* b, size_t bn) noexcept {
+    size_t za = 0, zb = 0;
+    while (!a[za]) ++za;
+    while (!b[zb]) ++zb;
+    za = za * bits<L> + std::countr_zero(a[za]);
+    zb = zb * bits<L> + std::countr_zero(b[zb]);
+    size_t z = std::min(za, zb);
+    an = strip_twos(a, an);
+    bn = strip_twos(b, bn);
+    // both are odd from now on
+    while (int c = cmp_sized(a, an, b, bn)) {
+        if (an == 1 && bn == 1) {
+            a[0] = gcd_1(a[0], b[0]);
+            break;
+        }
+        if (c < 0) {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        sub_from(a, an, b, bn);
+        an = strip_twos(a, an);
+    }
+    size_t w = z / bits<L>, rn = w + an;
+    zero_n(r, w);
+    if (unsigned cnt = z % bits<L>) {
+        if (L out = lshift(r + w, a, an, cnt)) r[rn++] = out;
+    } else {
+        copy_n(r + w, a, an);
+    }
+    return rn;
+}
+
+// r = x * a + y * b where x and y have opposite signs and the result is non-negative
+template<typename L>
+constexpr void lincomb(L* r, const L* a, const L* b, size_t n, std::int64_t x, std::int64_t y) noexcept {
+    if (y > 0) {
+        std::swap(a, b);
+        std::swap(x, y);
+    }
+    r[n] = mul_1(r, a, n, L(x));
+    r[n] -= submul_1(r, b, n, L(-y));
+}
+
+/*
+ * below LEHMER_THRESHOLD limbs the binary algorithm is faster, above it
+ * Lehmer's algorithm runs Euclid on the leading 62 bits and applies the
+ * collected cofactors to the full numbers at once, TAOCP Vol. 2, 4.5.2
+ *
+ * it needs at least 2 limbs to take the leading bits from
+ */
+constexpr size_t LEHMER_THRESHOLD = 2;
+
+constexpr size_t gcd_scratch(size_t n) noexcept {
+    return 3 * (n + 1) + divrem_scratch(n, n);
+}
+
+/*
+ * r = gcd(a, b) where a and b are nonzero and trimmed, both with room for
+ * n = max(an, bn) limbs and zeros above, returns the significant limbs of r;
+ * a and b are destroyed
+ */
+template<typename L>
+constexpr size_t gcd(L* r, L* a, size_t an, L* b, size_t bn, L* scratch) noexcept {
+    if constexpr (bits<L> == 64) {
+        size_t n = std::max(an, bn);
+        L* t1 = scratch;
+        L* t2 = t1 + n + 1;
+        L* q = t2 + n + 1;
+        L* next = q + n + 1;
+        // the 62 bits of a number starting from the pos-th bit, where none is above
+        auto leading = [n](const L* a, size_t pos) {
+            size_t w = pos / 64, off = pos % 64;
+            L v = a[w] >> off;
+            if (off && w + 1 < n) v |= a[w + 1] << (64 - off);
+            return std::int64_t(v);
+        };
+        if (an < bn || (an == bn && cmp_n(a, b, an) < 0)) {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        while (bn && an >= LEHMER_THRESHOLD) {
+            size_t pos = (an - 1) * 64 + std::bit_width(a[an - 1]) - 62;
+            std::int64_t x = leading(a, pos), y = leading(b, pos);
+            std::int64_t A = 1, B = 0, C = 0, D = 1;
+            while (y + C && y + D) {
+                std::int64_t q1 = (x + A) / (y + C), q2 = (x + B) / (y + D);
+                if (q1 != q2) break;
+                std::int64_t t = A - q1 * C;
+                A = C; C = t;
+                t = B - q1 * D;
+                B = D; D = t;
+                t = x - q1 * y;
+                x = y; y = t;
+            }
+            if (B == 0) {
+                // the leading bits tell nothing, so one step of Euclid in full
+                divrem(q, t1, a, an, b, bn, next);
+                copy_n(a, t1, bn);
+                zero_n(a + bn, an - bn);
+                an = bn;
+                while (an && !a[an - 1]) --an;
+            } else {
+                lincomb(t1, a, b, an, A, B);
+                lincomb(t2, a, b, an, C, D);
+                copy_n(a, t1, an);
+                copy_n(b, t2, an);
+                bn = an;
+                while (an && !a[an - 1]) --an;
+                while (bn && !b[bn - 1]) --bn;
+            }
+            if (an < bn || (an == bn && cmp_n(a, b, an) < 0)) {
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+        }
+        if (!bn) {
+            copy_n(r, a, an);
+            return an;
+        }
+    }
+    return gcd_binary(r, a, an, b, bn);
+}
+
+
+/*
+ * uniformly random limbs from a uniform random bit generator
+ */
+
+// one limb of random bits, from as few calls to the engine as its range allows
+template<typename L, typename G>
+constexpr L random(G& g) {
+    constexpr auto range = G::max() - G::min();
+    if constexpr (G::min() == 0 && (range & (range + 1)) == 0) {
+        constexpr size_t width = std::bit_width(range);
+        if constexpr (width >= bits<L>) {
+            return L(g());
+        } else {
+            L r = 0;
+            for (size_t s = 0; s < bits<L>; s += width) r |= L(L(g()) << s);
+            return r;
+        }
+    } else {
+        return L(std::uniform_int_distribution<std::uint64_t>(0, L(~L(0)))(g));
+    }
+}
+
+template<typename L, typename G>
+constexpr void random_fill(L* r, size_t n, G& g) {
+    for (size_t i = 0; i < n; ++i) r[i] = random<L>(g);
+}
+
+/*
+ * a random number in [0, s) where s > 0, by Lemire's multiply-and-reject,
+ * "Fast random integer generation in an interval" (2019)
+ * the division for the rejection threshold happens only with probability s / 2^bits<L>
+ */
+template<typename L, typename G>
+constexpr L random_below(G& g, L s) {
+    L hi, lo = mul_wide(random<L>(g), s, hi);
+    if (lo < s) {
+        L threshold = L(L(0) - s) % s;
+        while (lo < threshold) lo = mul_wide(random<L>(g), s, hi);
+    }
+    return hi;
+}
+
+/*
+ * r = a random number in [0, upper] where the highest limb of upper is nonzero
+ * the highest limb is drawn in range by random_below and the others from the top,
+ * the draw starts over only when it passes upper, a chance below 1 / (upper[n - 1] + 1)
+ */
+template<typename L, typename G>
+constexpr void random_upto(L* r, const L* upper, size_t n, G& g) {
+    for (;;) {
+        r[n - 1] = upper[n - 1] == L(~L(0)) ? random<L>(g) : random_below(g, L(upper[n - 1] + 1));
+        size_t i = n - 1;
+        while (i && r[i] == upper[i]) {
+            --i;
+            r[i] = random<L>(g);
+        }
+        if (r[i] <= upper[i]) {
+            // once below upper, the rest is free
+            random_fill(r, i, g);
+            return;
+        }
+    }
+}
+
+}
+
+#endif
@@ -1,32 +1,107 @@
 #include <vector>
 #include <cstdint>
 #include <cmath>
+#include <stdexcept>
+#include <string>
 
 struct LinearPrimeEngine {
     using int_t = std::uintmax_t;
-    std::vector<int_t> primes;
-    std::vector<bool> is_not_prime = {1, 1, 0, 0, 1, 0, 1, 0, 1, 1, 1};
-    LinearPrimeEngine(int_t L) {
-        if (L <= 10) {
-            primes = {2, 3, 5, 7};
-            return;
-        }
-        is_not_prime.resize(L + 1);
+
+    // the tables to fill in the same pass besides the primes, or-ed together
+    enum tables : unsigned {
+        none = 0,
+        smallest_factor = 1,
+        totient = 2,
+        mobius = 4,
+        divisor_count = 8,
+        all = 15
+    };
+
+    // the primes are below 2^32 and take 4 bytes each
+    using prime_t = uint32_t;
+
+    std::vector<prime_t> primes;
+    // bit n / 2 of word n / 128 for each odd n up to L, the even numbers need no bits
+    std::vector<uint64_t> odd_composite;
+    // indexed by n up to L, with 0 for 0 and 1 in spf
+    std::vector<uint32_t> spf;
+    std::vector<uint32_t> phi;
+    std::vector<int8_t> mu;
+    std::vector<uint16_t> divisors;
+    // the bytes held at once at the peak of the construction
+    size_t peak_memory = 0;
+
+    LinearPrimeEngine(int_t L, unsigned with = none) {
+        // the initial table covers up to 10 anyway
+        L = std::max<int_t>(L, 10);
+        if (L > UINT32_MAX) throw std::invalid_argument("the primes are held in 32 bits only");
+        odd_composite.resize(L / 128 + 1);
         double ln = std::log(L);
         size_t estimate = L / (ln - 1.1);
         primes.reserve(estimate);
-        for (int_t i = 2; i <= L; ++i) {
-            if (!is_not_prime[i]) primes.push_back(i);
-            for (int_t j : primes) {
-                if (i * j > L) break;
-                is_not_prime[i * j] = true;
-                if (i % j == 0) break;
+        // when the smallest prime factor is known, i % j == 0 is j == spf[i]
+        if (with & (smallest_factor | divisor_count)) spf.resize(L + 1);
+        if (with & totient) phi.resize(L + 1), phi[1] = 1;
+        if (with & mobius) mu.resize(L + 1), mu[1] = 1;
+        // d(i) comes from the exponent of the smallest prime of i
+        std::vector<uint8_t> exponent;
+        if (with & divisor_count) divisors.resize(L + 1), divisors[1] = 1, exponent.resize(L + 1);
+        peak_memory = memory() + exponent.capacity();
+        bool factors = !spf.empty(), tables = with & (totient | mobius | divisor_count);
+        // without the tables nothing even is marked, so the even numbers and 2 as a factor are skipped
+        bool odd_only = !tables && !factors;
+        for (int_t i = 2; i <= L; i += odd_only && i > 2 ? 2 : 1) {
+            if (is_prime(i)) {
+                primes.push_back(prime_t(i));
+                if (factors) spf[i] = uint32_t(i);
+                if (!phi.empty()) phi[i] = uint32_t(i - 1);
+                if (!mu.empty()) mu[i] = -1;
+                if (!divisors.empty()) divisors[i] = 2, exponent[i] = 1;
+            }
+            // i * j <= L without overflow
+            int_t bound = L / i;
+            for (size_t index = odd_only; index < primes.size(); ++index) {
+                int_t j = primes[index];
+                if (j > bound) break;
+                int_t k = i * j;
+                if (k & 1) odd_composite[k / 128] |= uint64_t(1) << (k / 2 % 64);
+                bool last = factors ? j == spf[i] : i % j == 0;
+                if (factors) spf[k] = uint32_t(j);
+                if (tables) {
+                    // j is below the smallest prime of i, or is that prime once more
+                    if (!phi.empty()) phi[k] = uint32_t(phi[i] * (last ? j : j - 1));
+                    if (!mu.empty()) mu[k] = int8_t(last ? 0 : -mu[i]);
+                    if (!divisors.empty()) {
+                        exponent[k] = uint8_t(last ? exponent[i] + 1 : 1);
+                        divisors[k] = uint16_t(last ? divisors[i] / exponent[k] * (exponent[k] + 1) : 2 * divisors[i]);
+                    }
+                }
+                if (last) break;
             }
         }
+        // the factors were only borrowed for the divisor count
+        if (!(with & smallest_factor)) spf = {};
     }
 
     inline bool is_prime(int_t u) const {
-        return !is_not_prime[u];
+        if (!(u & 1)) return u == 2;
+        return u > 1 && !(odd_composite[u / 128] >> (u / 2 % 64) & 1);
+    }
+
+    // the bytes held by the tables
+    size_t memory() const {
+        return primes.capacity() * sizeof(prime_t) + odd_composite.capacity() * sizeof(uint64_t)
+            + spf.capacity() * sizeof(uint32_t) + phi.capacity() * sizeof(uint32_t)
+            + mu.capacity() * sizeof(int8_t) + divisors.capacity() * sizeof(uint16_t);
+    }
+
+    // the prime factors of 0 < n <= L in ascending order with multiplicity, by the smallest prime factors
+    std::vector<int_t> factor(int_t n) const {
+        if (spf.empty()) throw std::logic_error("no smallest prime factor table");
+        if (!n || n >= spf.size()) throw std::invalid_argument(std::to_string(n) + " is out of the table");
+        std::vector<int_t> ret;
+        for (; n > 1; n /= spf[n]) ret.push_back(spf[n]);
+        return ret;
     }
 
 };
@@ -8,4 +8,14 @@ int main() {
     for (LinearPrimeEngine::int_t p : lp.primes) {
         cout << p <<", ";
     }
+    cout << endl;
+    // 720720 = 2^4 * 3^2 * 5 * 7 * 11 * 13
+    LinearPrimeEngine tables(1000 * 1000, LinearPrimeEngine::all);
+    for (LinearPrimeEngine::int_t p : tables.factor(720720)) {
+        cout << p << ' ';
+    }
+    cout << endl;
+    cout << "phi = " << tables.phi[720720] << ", mu = " << int(tables.mu[720720]) << ", d = " << tables.divisors[720720] << endl;
+    return tables.phi[720720] != 138240 || tables.mu[720720] != 0 || tables.divisors[720720] != 240
+        || tables.mu[2310] != -1 || tables.primes != lp.primes;
 }
@@ -0,0 +1,324 @@
+#include <cstdint>
+#include <stdexcept>
+
+#include "wide_int.cpp"
+
+#ifndef YAO_MATH_MODULAR
+#define YAO_MATH_MODULAR
+
+namespace yao_math {
+
+namespace modular {
+
+// the width of the sliding window for an exponent of the given bits
+constexpr size_t window_bits(size_t bits) noexcept {
+    return bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 6 ? 2 : 1;
+}
+
+constexpr size_t MAX_WINDOW_BITS = 6;
+
+/*
+ * x ^ e by the left-to-right sliding window over the odd powers of x,
+ * the context provides one(), mul() and sqr() in its own representation
+ */
+template<typename Context, size_t M, bool R>
+constexpr typename Context::value_type pow(Context const& ctx,
+        typename Context::value_type const& x, wide_int<M, R> const& e) {
+    using value_type = typename Context::value_type;
+    if (e.is_negative()) throw std::invalid_argument("negative exponent");
+    if (!e) return ctx.one();
+    auto bit = [&e](size_t i) -> unsigned {
+        return (e.limbs[i / e.LIMB_BITS] >> (i % e.LIMB_BITS)) & 1;
+    };
+    size_t top = e.log2();
+    size_t w = window_bits(top + 1);
+    // table[i] = x ^ (2i + 1)
+    value_type table[size_t(1) << (MAX_WINDOW_BITS - 1)];
+    table[0] = x;
+    if (w > 1) {
+        value_type x2 = ctx.sqr(x);
+        for (size_t i = 1; i < (size_t(1) << (w - 1)); ++i) {
+            table[i] = ctx.mul(table[i - 1], x2);
+        }
+    }
+    value_type ret;
+    bool started = false;
+    for (size_t i = top; /* i >= 0 */ ~i; ) {
+        if (!bit(i)) {
+            ret = ctx.sqr(ret);
+            --i;
+            continue;
+        }
+        // the longest window of at most w bits from i ending in a set bit
+        size_t low = i + 1 >= w ? i + 1 - w : 0;
+        while (!bit(low)) ++low;
+        size_t window = 0;
+        for (size_t j = i; j >= low && /* j >= 0 */ ~j; --j) window = window << 1 | bit(j);
+        if (started) {
+            for (size_t j = low; j <= i; ++j) ret = ctx.sqr(ret);
+            ret = ctx.mul(ret, table[window >> 1]);
+        } else {
+            ret = table[window >> 1];
+            started = true;
+        }
+        i = low - 1;
+    }
+    return ret;
+}
+
+}
+
+/*
+ * arithmetic modulo an odd m on the Montgomery form x * R mod m, R = 2^N,
+ * where a product is reduced by limb-wise multiples of m instead of division
+ */
+template<size_t N>
+class montgomery_context {
+public:
+    using value_type = wide_int<N, false>;
+    using limb_type = typename value_type::limb_type;
+
+private:
+    constexpr static size_t LIMBS = value_type::LIMBS;
+
+    value_type m, r1, r2; // m, R mod m, R^2 mod m
+    limb_type inv;        // -1 / m mod 2^LIMB_BITS
+
+    // t / R mod m where t < m * R has 2 * LIMBS limbs, t is destroyed
+    constexpr value_type redc(limb_type* t) const noexcept {
+        for (size_t i = 0; i < LIMBS; ++i) {
+            limb_type u = limb_type(t[i] * inv);
+            // the limb cleared by u keeps the carry which belongs LIMBS limbs higher
+            t[i] = limb::addmul_1(t + i, m.limbs, LIMBS, u);
+        }
+        value_type ret;
+        limb_type carry = limb::add_n(ret.limbs, t + LIMBS, t, LIMBS);
+        if (carry || limb::cmp_n(ret.limbs, m.limbs, LIMBS) >= 0) {
+            limb::sub_n(ret.limbs, ret.limbs, m.limbs, LIMBS);
+        }
+        return ret;
+    }
+
+public:
+    constexpr explicit montgomery_context(value_type const& modulus) : m(modulus) {
+        if (!(m.limbs[0] & 1)) throw std::invalid_argument("even modulus");
+        // an odd m is its own inverse modulo 8, and each Newton step doubles the correct bits
+        limb_type x = m.limbs[0];
+        for (size_t bits = 3; bits < value_type::LIMB_BITS; bits *= 2) {
+            x = limb_type(x * limb_type(2 - limb_type(m.limbs[0] * x)));
+        }
+        inv = limb_type(0 - x);
+        r1 = (value_type(0) - m) % m;
+        // R^2 mod m by a single long division
+        size_t mn = m.significant_limbs();
+        limb_type a[2 * LIMBS + 1] = {}, q[2 * LIMBS + 2] = {};
+        limb_type scratch[limb::divrem_scratch(2 * LIMBS + 1, LIMBS)] = {};
+        a[2 * LIMBS] = 1;
+        limb::divrem(q, r2.limbs, a, 2 * LIMBS + 1, m.limbs, mn, scratch);
+    }
+
+    constexpr value_type const& modulus() const noexcept {
+        return m;
+    }
+
+    // 1 in the Montgomery form
+    constexpr value_type const& one() const noexcept {
+        return r1;
+    }
+
+    // any x, not only the ones below m
+    constexpr value_type to_montgomery(value_type const& x) const noexcept {
+        return mul(x, r2);
+    }
+
+    constexpr value_type from_montgomery(value_type const& x) const noexcept {
+        limb_type t[2 * LIMBS] = {};
+        limb::copy_n(t, x.limbs, LIMBS);
+        return redc(t);
+    }
+
+    // the operands of the following are all in the Montgomery form and below m
+
+    constexpr value_type mul(value_type const& a, value_type const& b) const noexcept {
+        limb_type t[2 * LIMBS];
+        limb_type scratch[limb::mul_scratch(LIMBS) + 1];
+        limb::mul_n(t, a.limbs, b.limbs, LIMBS, scratch);
+        return redc(t);
+    }
+
+    constexpr value_type sqr(value_type const& a) const noexcept {
+        return mul(a, a);
+    }
+
+    constexpr value_type add(value_type const& a, value_type const& b) const noexcept {
+        value_type ret;
+        limb_type carry = limb::add_n(ret.limbs, a.limbs, b.limbs, LIMBS);
+        if (carry || ret >= m) ret -= m;
+        return ret;
+    }
+
+    constexpr value_type sub(value_type const& a, value_type const& b) const noexcept {
+        value_type ret;
+        if (limb::sub_n(ret.limbs, a.limbs, b.limbs, LIMBS)) ret += m;
+        return ret;
+    }
+
+    template<size_t M, bool R>
+    constexpr value_type pow(value_type const& x, wide_int<M, R> const& e) const {
+        return modular::pow(*this, x, e);
+    }
+
+    // the operands of the following are plain numbers
+
+    constexpr value_type mulmod(value_type const& a, value_type const& b) const noexcept {
+        // a * R * b / R needs no conversion back
+        return mul(to_montgomery(a), b);
+    }
+
+    template<size_t M, bool R>
+    constexpr value_type powmod(value_type const& x, wide_int<M, R> const& e) const {
+        return from_montgomery(pow(to_montgomery(x), e));
+    }
+};
+
+/*
+ * arithmetic modulo any m > 0 on plain residues, where a product is
+ * reduced by multiplying with the precomputed reciprocal of m
+ */
+template<size_t N>
+class barrett_context {
+public:
+    using value_type = wide_int<N, false>;
+    using limb_type = typename value_type::limb_type;
+
+private:
+    constexpr static size_t LIMBS = value_type::LIMBS;
+
+    value_type m;
+    size_t k;                   // the significant limbs of m
+    limb_type mu[LIMBS + 2];    // floor(B^2k / m), B = 2^LIMB_BITS
+    size_t mun;
+
+    // t mod m where t has 2k limbs, HAC 14.42
+    constexpr value_type reduce(const limb_type* t) const noexcept {
+        // q = floor(floor(t / B^(k-1)) * mu / B^(k+1)) undershoots by at most 2
+        limb_type q2[2 * LIMBS + 3], r[2 * LIMBS + 3];
+        limb_type scratch[limb::mul_scratch(LIMBS + 2, LIMBS + 2) + 1];
+        const limb_type* q1 = t + k - 1;
+        if (k + 1 >= mun) limb::mul(q2, q1, k + 1, mu, mun, scratch);
+        else limb::mul(q2, mu, mun, q1, k + 1, scratch);
+        const limb_type* q3 = q2 + k + 1;
+        size_t qn = mun;
+        while (qn && !q3[qn - 1]) --qn;
+        value_type ret;
+        if (qn) {
+            // only the low k + 1 limbs of q * m are needed
+            if (qn >= k) limb::mul(r, q3, qn, m.limbs, k, scratch);
+            else limb::mul(r, m.limbs, k, q3, qn, scratch);
+        } else {
+            limb::zero_n(r, k + 1);
+        }
+        limb_type rem[LIMBS + 1];
+        limb::sub_n(rem, t, r, k + 1);
+        while (limb::cmp(rem, k + 1, m.limbs, k) >= 0) {
+            limb::sub_from(rem, k + 1, m.limbs, k);
+        }
+        limb::copy_n(ret.limbs, rem, k);
+        return ret;
+    }
+
+public:
+    constexpr explicit barrett_context(value_type const& modulus) : m(modulus), k(modulus.significant_limbs()) {
+        if (!k) throw std::invalid_argument("zero modulus");
+        limb_type a[2 * LIMBS + 1] = {}, rem[LIMBS] = {};
+        limb_type scratch[limb::divrem_scratch(2 * LIMBS + 1, LIMBS)] = {};
+        a[2 * k] = 1;
+        limb::zero_n(mu, LIMBS + 2);
+        limb::divrem(mu, rem, a, 2 * k + 1, m.limbs, k, scratch);
+        mun = k + 2;
+        while (!mu[mun - 1]) --mun;
+    }
+
+    constexpr value_type const& modulus() const noexcept {
+        return m;
+    }
+
+    constexpr value_type one() const noexcept {
+        return m == value_type(1) ? value_type(0) : value_type(1);
+    }
+
+    constexpr value_type reduce(value_type const& x) const noexcept {
+        if (x.significant_limbs() > 2 * k) return x % m;
+        limb_type t[2 * LIMBS] = {};
+        limb::copy_n(t, x.limbs, LIMBS);
+        return reduce(t);
+    }
+
+    // the operands of the following are all below m
+
+    constexpr value_type mul(value_type const& a, value_type const& b) const noexcept {
+        limb_type t[2 * LIMBS] = {};
+        if constexpr (limb::mul_scratch(LIMBS) == 0) {
+            limb::mul_basecase(t, a.limbs, k, b.limbs, k);
+        } else {
+            limb_type scratch[limb::mul_scratch(LIMBS)];
+            limb::mul_n(t, a.limbs, b.limbs, k, scratch);
+        }
+        return reduce(t);
+    }
+
+    constexpr value_type sqr(value_type const& a) const noexcept {
+        return mul(a, a);
+    }
+
+    constexpr value_type add(value_type const& a, value_type const& b) const noexcept {
+        value_type ret;
+        limb_type carry = limb::add_n(ret.limbs, a.limbs, b.limbs, LIMBS);
+        if (carry || ret >= m) ret -= m;
+        return ret;
+    }
+
+    constexpr value_type sub(value_type const& a, value_type const& b) const noexcept {
+        value_type ret;
+        if (limb::sub_n(ret.limbs, a.limbs, b.limbs, LIMBS)) ret += m;
+        return ret;
+    }
+
+    template<size_t M, bool R>
+    constexpr value_type pow(value_type const& x, wide_int<M, R> const& e) const {
+        return modular::pow(*this, x, e);
+    }
+
+    // the operands of the following are any numbers
+
+    constexpr value_type mulmod(value_type const& a, value_type const& b) const noexcept {
+        return mul(reduce(a), reduce(b));
+    }
+
+    template<size_t M, bool R>
+    constexpr value_type powmod(value_type const& x, wide_int<M, R> const& e) const {
+        return pow(reduce(x), e);
+    }
+};
+
+// the inverse of x modulo m, which must be coprime
+template<size_t N>
+constexpr wide_int<N, false> invmod(wide_int<N, false> const& x, wide_int<N, false> const& m) {
+    auto [g, s, t] = gcdext(x % m, m);
+    if (g != wide_int<N, false>(1)) throw std::invalid_argument("not invertible");
+    wide_int<N, false> ret = s;
+    if (s.is_negative()) ret += m;
+    return ret;
+}
+
+// x ^ e mod m, by Montgomery multiplication for an odd m and Barrett reduction otherwise
+template<size_t N, size_t M, bool R>
+constexpr wide_int<N, false> powmod(wide_int<N, false> const& x, wide_int<M, R> const& e,
+                                    wide_int<N, false> const& m) {
+    if (m.limbs[0] & 1) return montgomery_context<N>(m).powmod(x, e);
+    return barrett_context<N>(m).powmod(x, e);
+}
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include "modular.cpp"
+
+#include <iostream>
+
+// Fermat's little theorem on 2^255 - 19 and 2^127 - 1
+constexpr yao_math::uint256 p25519 = (yao_math::uint256(1) << 255) - yao_math::uint256(19);
+static_assert(yao_math::powmod(yao_math::uint256(2), p25519 - yao_math::uint256(1), p25519) == yao_math::uint256(1));
+static_assert(yao_math::barrett_context<256>(p25519).powmod(yao_math::uint256(3), p25519) == yao_math::uint256(3));
+constexpr yao_math::uint128 m127 = (yao_math::uint128(1) << 127) - yao_math::uint128(1);
+static_assert(yao_math::montgomery_context<128>(m127).mulmod(m127 - yao_math::uint128(1), m127 - yao_math::uint128(1)) == yao_math::uint128(1));
+// an even modulus goes through Barrett reduction
+static_assert(yao_math::powmod(yao_math::uint256(3), yao_math::uint256(200), yao_math::uint256(1) << 200) 
+    == yao_math::pow(yao_math::uint256(3), 200) % (yao_math::uint256(1) << 200));
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    montgomery_context<512> ctx((uint512(1) << 511) - uint512(187));
+    uint512 x = ctx.to_montgomery(uint512(12345));
+    cout << ctx.from_montgomery(ctx.pow(x, ctx.modulus() - uint512(2))) << endl;
+}
@@ -0,0 +1,219 @@
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+#include <bit>
+#include <algorithm>
+
+#ifndef YAO_MATH_PRIMALITY
+#define YAO_MATH_PRIMALITY
+
+namespace yao_math {
+
+/*
+ * arithmetic modulo an odd 64-bit n on the Montgomery form x * 2^64 mod n,
+ * a product costs three multiplications and no division
+ */
+struct montgomery64 {
+    uint64_t n;
+    uint64_t inv;       // 1 / n mod 2^64
+    uint64_t one;       // 2^64 mod n
+    uint64_t minus_one;
+    uint64_t r2;        // 2^128 mod n
+
+    constexpr explicit montgomery64(uint64_t n) noexcept : n(n), inv(n), one((0 - n) % n), minus_one(n - one),
+        r2(uint64_t((unsigned __int128)one * one % n)) {
+        // an odd n is its own inverse modulo 8, and each Newton step doubles the correct bits
+        for (int i = 0; i < 5; ++i) inv *= 2 - n * inv;
+    }
+
+    // t / 2^64 mod n for t < n * 2^64, the low halves of t and q * n cancel out
+    constexpr uint64_t redc(unsigned __int128 t) const noexcept {
+        uint64_t q = uint64_t(t) * inv;
+        uint64_t high = uint64_t(t >> 64), sub = uint64_t((unsigned __int128)q * n >> 64);
+        return high >= sub ? high - sub : high - sub + n;
+    }
+
+    constexpr uint64_t mul(uint64_t a, uint64_t b) const noexcept {
+        return redc((unsigned __int128)a * b);
+    }
+
+    // any x, not only the ones below n
+    constexpr uint64_t to_montgomery(uint64_t x) const noexcept {
+        return mul(x % n, r2);
+    }
+
+    constexpr uint64_t from_montgomery(uint64_t x) const noexcept {
+        return redc(x);
+    }
+
+    constexpr uint64_t pow(uint64_t x, uint64_t e) const noexcept {
+        uint64_t ret = one;
+        for (int i = std::bit_width(e) - 1; i >= 0; --i) {
+            ret = mul(ret, ret);
+            if (e >> i & 1) ret = mul(ret, x);
+        }
+        return ret;
+    }
+};
+
+namespace primality {
+
+// the odd primes for trial division, each with its inverse modulo 2^64 and the biggest quotient
+struct small_prime {
+    uint64_t p, inv, limit;
+};
+
+constexpr std::array<small_prime, 15> small_primes = [] {
+    constexpr uint64_t primes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+    std::array<small_prime, 15> ret{};
+    for (size_t i = 0; i < ret.size(); ++i) {
+        uint64_t p = primes[i], inv = p;
+        for (int j = 0; j < 5; ++j) inv *= 2 - p * inv;
+        ret[i] = {p, inv, UINT64_MAX / p};
+    }
+    return ret;
+}();
+
+// the bases of Jaeschke for n < 4759123141, and of Sinclair for all the 64-bit n
+constexpr uint64_t bases32[] = {2, 7, 61};
+constexpr uint64_t bases64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+enum class verdict { composite, prime, unknown };
+
+// settles the numbers with a factor up to 53 and the primes below 53^2
+constexpr verdict prefilter(uint64_t n) noexcept {
+    if (n < 4) return n >= 2 ? verdict::prime : verdict::composite;
+    if (!(n & 1)) return verdict::composite;
+    for (auto const& each : small_primes) {
+        // p divides n exactly when n / p, i.e. n * inv, is an integer below 2^64 / p
+        if (n * each.inv <= each.limit) return n == each.p ? verdict::prime : verdict::composite;
+    }
+    return n < 53 * 53 ? verdict::prime : verdict::unknown;
+}
+
+// a strong probable prime test of the odd n > 2 to the given base
+constexpr bool strong_probable_prime(montgomery64 const& ctx, uint64_t base) noexcept {
+    uint64_t n = ctx.n;
+    int s = std::countr_zero(n - 1);
+    uint64_t a = base % n;
+    if (!a) return true;
+    uint64_t x = ctx.pow(ctx.to_montgomery(a), (n - 1) >> s);
+    if (x == ctx.one || x == ctx.minus_one) return true;
+    for (int i = 1; i < s; ++i) {
+        x = ctx.mul(x, x);
+        if (x == ctx.minus_one) return true;
+    }
+    return false;
+}
+
+constexpr size_t LANES = 4;
+
+/*
+ * the tests of up to LANES numbers side by side, so that the independent
+ * multiplications of the lanes overlap in the pipeline instead of waiting
+ * out the latency of each other; the unused lanes repeat the last number
+ */
+constexpr void miller_rabin_lanes(uint64_t const* n, size_t count, bool* prime) noexcept {
+    uint64_t m[LANES];
+    for (size_t l = 0; l < LANES; ++l) m[l] = n[l < count ? l : count - 1];
+    montgomery64 ctx[LANES] = {montgomery64(m[0]), montgomery64(m[1]), montgomery64(m[2]), montgomery64(m[3])};
+    uint64_t d[LANES], top = 0;
+    int s[LANES];
+    bool small = true, composite[LANES] = {};
+    for (size_t l = 0; l < LANES; ++l) {
+        s[l] = std::countr_zero(m[l] - 1);
+        d[l] = (m[l] - 1) >> s[l];
+        top |= d[l];
+        small &= m[l] < 4759123141;
+    }
+    std::span<uint64_t const> bases = small ? std::span<uint64_t const>(bases32) : std::span<uint64_t const>(bases64);
+    for (uint64_t base : bases) {
+        uint64_t a[LANES], x[LANES];
+        bool skip[LANES];
+        for (size_t l = 0; l < LANES; ++l) {
+            skip[l] = composite[l] || base % m[l] == 0;
+            a[l] = ctx[l].to_montgomery(base);
+            x[l] = ctx[l].one;
+        }
+        // the shorter exponents square one until their top bit comes,
+        // and the product is always taken, an unpredictable branch costing more
+        for (int i = std::bit_width(top) - 1; i >= 0; --i) {
+#pragma GCC unroll 4
+            for (size_t l = 0; l < LANES; ++l) {
+                x[l] = ctx[l].mul(x[l], x[l]);
+                uint64_t y = ctx[l].mul(x[l], a[l]);
+                x[l] = d[l] >> i & 1 ? y : x[l];
+            }
+        }
+        bool all = true;
+        for (size_t l = 0; l < LANES; ++l) {
+            if (skip[l] || x[l] == ctx[l].one || x[l] == ctx[l].minus_one) {
+                all &= composite[l];
+                continue;
+            }
+            int i = 1;
+            for (; i < s[l]; ++i) {
+                x[l] = ctx[l].mul(x[l], x[l]);
+                if (x[l] == ctx[l].minus_one) break;
+            }
+            composite[l] = i >= s[l];
+            all &= composite[l];
+        }
+        if (all) break;
+    }
+    for (size_t l = 0; l < count; ++l) prime[l] = !composite[l];
+}
+
+}
+
+// deterministic for all the 64-bit n, by trial division up to 53 and Miller-Rabin
+constexpr bool is_prime(uint64_t n) noexcept {
+    using namespace primality;
+    verdict v = prefilter(n);
+    if (v != verdict::unknown) return v == verdict::prime;
+    montgomery64 ctx(n);
+    if (n < 4759123141) {
+        for (uint64_t base : bases32) if (!strong_probable_prime(ctx, base)) return false;
+    } else {
+        for (uint64_t base : bases64) if (!strong_probable_prime(ctx, base)) return false;
+    }
+    return true;
+}
+
+/*
+ * tests the candidates in blocks, the ones left by the trial division going
+ * to Miller-Rabin LANES at a time, and writes the verdicts to out in order
+ */
+template<typename OutputIt>
+constexpr OutputIt is_prime(std::span<uint64_t const> candidates, OutputIt out) {
+    using namespace primality;
+    constexpr size_t BLOCK = 64;
+    for (size_t begin = 0; begin < candidates.size(); begin += BLOCK) {
+        size_t size = std::min(BLOCK, candidates.size() - begin);
+        bool prime[BLOCK] = {};
+        size_t index[BLOCK], pending = 0;
+        uint64_t values[BLOCK];
+        for (size_t i = 0; i < size; ++i) {
+            verdict v = prefilter(candidates[begin + i]);
+            if (v == verdict::unknown) {
+                index[pending] = i;
+                values[pending++] = candidates[begin + i];
+            } else {
+                prime[i] = v == verdict::prime;
+            }
+        }
+        for (size_t i = 0; i < pending; i += LANES) {
+            bool lanes[LANES];
+            size_t count = std::min(LANES, pending - i);
+            miller_rabin_lanes(values + i, count, lanes);
+            for (size_t l = 0; l < count; ++l) prime[index[i + l]] = lanes[l];
+        }
+        for (size_t i = 0; i < size; ++i) *out++ = prime[i];
+    }
+    return out;
+}
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "primality.cpp"
+
+#include <iostream>
+#include <vector>
+
+// the strong pseudoprimes to the first bases, and the biggest 64-bit prime
+static_assert(!yao_math::is_prime(3215031751) && !yao_math::is_prime(3825123056546413051));
+static_assert(yao_math::is_prime(4759123129) && !yao_math::is_prime(4759123141));
+static_assert(yao_math::is_prime(18446744073709551557u) && !yao_math::is_prime(18446744073709551615u));
+static_assert(!yao_math::is_prime(4294967291u * 4294967279u) && yao_math::is_prime(2809 + 52));
+static_assert([] {
+    size_t count = 0;
+    for (uint64_t n = 0; n < 10000; ++n) count += yao_math::is_prime(n);
+    return count == 1229;
+}());
+static_assert(yao_math::montgomery64(1000000007).from_montgomery(
+    yao_math::montgomery64(1000000007).pow(yao_math::montgomery64(1000000007).to_montgomery(2), 1000000006)) == 1);
+
+int main() {
+    using namespace std;
+    // the batch agrees with one at a time
+    vector<uint64_t> candidates;
+    for (uint64_t n = 18446744073709551557u - 1000; n; ++n) candidates.push_back(n);
+    vector<bool> primes;
+    yao_math::is_prime(candidates, back_inserter(primes));
+    int ret = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (primes[i] != yao_math::is_prime(candidates[i])) ret = 1;
+        if (primes[i]) cout << candidates[i] << endl;
+    }
+    return ret;
+}
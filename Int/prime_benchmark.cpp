@@ -1,10 +1,21 @@
 #include <iostream>
 #include <string>
-#include <functional>
+#include <string_view>
 #include <cmath>
-#include <map>
 #include <chrono>
 #include <iomanip>
+#include <thread>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "sieve_prime.cpp"
+#include "linear_prime.cpp"
+#include "primality.cpp"
+#include "factor.cpp"
+#include "prime_count.cpp"
+#include "prime_range.cpp"
+#include "benchmark.cpp"
 
 bool is_prime_odd(unsigned long long n) {
 	if (n < 2) return false;
@@ -33,18 +44,231 @@ bool is_prime_hexa(unsigned long long n) {
 	return true;
 }
 
+// the timings of one benchmark on one input, in nanoseconds per repetition
+struct Result {
+	std::string name, input;
+	size_t items;		// the numbers tested or the primes found in a repetition
+	uint64_t value;		// what each repetition computed, to compare across runs
+	std::vector<double> times;
+
+	// by the nearest rank, so the median of 5 is the third and the p99 of fewer than 100 the slowest
+	double quantile(double q) const {
+		size_t rank = std::max<size_t>(size_t(std::ceil(q * times.size())), 1);
+		return times[rank - 1];
+	}
+};
+
+/* runs each benchmark once to warm up and then a number of repetitions
+ * timed apart by steady_clock, printing a table as it goes, or CSV or JSON
+ * at the end for diffing across releases
+ */
+class Harness {
+public:
+	enum format_t { table, csv, json };
+
+private:
+	format_t format;
+	bool quick;
+	std::string filter;
+	std::vector<Result> results;
+
+public:
+	Harness(format_t format, bool quick, std::string filter) : format(format), quick(quick), filter(std::move(filter)) {
+		if (format == table) {
+			std::cout << std::left << std::setw(20) << "benchmark" << std::setw(20) << "input" << std::right
+				<< std::setw(12) << "items" << std::setw(14) << "median ms" << std::setw(14) << "p99 ms"
+				<< std::setw(10) << "ns/item" << std::setw(16) << "value" << std::endl;
+		}
+	}
+
+	// f returns what it computed over the items, or the items themselves when none are given
+	template<typename F>
+	void run(std::string name, std::string input, size_t items, size_t repetitions, F&& f) {
+		if (name.find(filter) == std::string::npos) return;
+		if (quick) repetitions = std::min<size_t>(repetitions, 3);
+		uint64_t value = uint64_t(f());
+		Result result{std::move(name), std::move(input), items ? items : size_t(value), value, {}};
+		for (size_t i = 0; i < repetitions; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			auto each = f();
+			auto stop = std::chrono::steady_clock::now();
+			do_not_optimize(each);
+			result.times.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+		}
+		std::sort(result.times.begin(), result.times.end());
+		if (format == table) {
+			double median = result.quantile(0.5);
+			std::cout << std::left << std::setw(20) << result.name << std::setw(20) << result.input << std::right
+				<< std::setw(12) << result.items << std::fixed << std::setprecision(3)
+				<< std::setw(14) << median * 1e-6 << std::setw(14) << result.quantile(0.99) * 1e-6
+				<< std::setprecision(1) << std::setw(10) << median / result.items << std::defaultfloat
+				<< std::setw(16) << result.value << std::endl;
+		}
+		results.push_back(std::move(result));
+	}
+
+	void print(std::ostream& out) const {
+		out << std::setprecision(12);
+		if (format == csv) {
+			out << "benchmark,input,items,repetitions,value,min_ns,median_ns,p99_ns,max_ns" << std::endl;
+			for (auto const& each : results) {
+				out << each.name << ',' << each.input << ',' << each.items << ',' << each.times.size() << ',' << each.value
+					<< ',' << each.times.front() << ',' << each.quantile(0.5) << ',' << each.quantile(0.99)
+					<< ',' << each.times.back() << std::endl;
+			}
+		} else if (format == json) {
+			out << '[' << std::endl;
+			for (size_t i = 0; i < results.size(); ++i) {
+				auto const& each = results[i];
+				out << "  {\"benchmark\": \"" << each.name << "\", \"input\": \"" << each.input << "\", \"items\": "
+					<< each.items << ", \"repetitions\": " << each.times.size() << ", \"value\": " << each.value
+					<< ", \"min_ns\": " << each.times.front() << ", \"median_ns\": " << each.quantile(0.5)
+					<< ", \"p99_ns\": " << each.quantile(0.99) << ", \"max_ns\": " << each.times.back() << '}'
+					<< (i + 1 < results.size() ? "," : "") << std::endl;
+			}
+			out << ']' << std::endl;
+		}
+	}
+};
+
+// the numbers to test, drawn with a fixed seed so that runs compare
+struct Inputs {
+	std::string name;
+	std::vector<uint64_t> values;
+};
+
+std::vector<Inputs> distributions() {
+	std::mt19937_64 random(2023);
+	std::vector<Inputs> ret;
+	auto draw = [&](std::string name, size_t count, uint64_t low, uint64_t width) {
+		std::vector<uint64_t> values(count);
+		for (auto& each : values) each = low + random() % width;
+		ret.push_back({std::move(name), std::move(values)});
+	};
+	draw("small", 1 << 16, 0, 1 << 20);
+	draw("near_2^32", 1 << 12, (uint64_t(1) << 32) - (1 << 24), 1 << 24);
+	draw("near_2^63", 1 << 16, (uint64_t(1) << 63) - (uint64_t(1) << 40), uint64_t(1) << 40);
+	std::vector<uint64_t> dense(1 << 16);
+	for (size_t i = 0; i < dense.size(); ++i) dense[i] = 1'000'000'000 + i;
+	ret.push_back({"dense_10^9", std::move(dense)});
+	return ret;
+}
+
+template<typename F>
+void run_test(Harness& harness, std::string name, Inputs const& inputs, size_t repetitions, F test) {
+	harness.run(std::move(name), inputs.name, inputs.values.size(), repetitions, [&] {
+		size_t count = 0;
+		for (uint64_t each : inputs.values) count += test(each);
+		return count;
+	});
+}
+
+// the tests of single numbers, where trial division near 2^63 would take billions of divisions each
+void bench_tests(Harness& harness) {
+	SievePrimeEngine sieve;
+	sieve.computeBelow(1 << 20);
+	LinearPrimeEngine linear(1 << 20);
+	for (auto const& inputs : distributions()) {
+		if (inputs.name != "near_2^63") {
+			run_test(harness, "trial_odd", inputs, 5, is_prime_odd);
+			run_test(harness, "trial_even", inputs, 5, is_prime_even);
+			run_test(harness, "trial_hexa", inputs, 5, is_prime_hexa);
+		}
+		run_test(harness, "miller_rabin", inputs, 15, [](uint64_t n) { return yao_math::is_prime(n); });
+		harness.run("miller_rabin_batch", inputs.name, inputs.values.size(), 15, [&] {
+			std::vector<bool> primes;
+			primes.reserve(inputs.values.size());
+			yao_math::is_prime(inputs.values, std::back_inserter(primes));
+			return std::count(primes.begin(), primes.end(), true);
+		});
+		// the engines look the sieved numbers up
+		if (inputs.name == "small") {
+			run_test(harness, "sieve_is_prime", inputs, 15, [&](uint64_t n) { return sieve.is_prime(n); });
+			run_test(harness, "linear_is_prime", inputs, 15, [&](uint64_t n) { return linear.is_prime(n); });
+		}
+		if (inputs.name != "dense_10^9") {
+			std::vector<uint64_t> nonzero;
+			std::copy_if(inputs.values.begin(), inputs.values.end(), std::back_inserter(nonzero), [](uint64_t n) { return n; });
+			run_test(harness, "factor", {inputs.name, nonzero}, 5, [](uint64_t n) { return yao_math::factor(n).size(); });
+			harness.run("factor_bulk", inputs.name, nonzero.size(), 5, [&] {
+				return yao_math::factor(nonzero).factors.size();
+			});
+		}
+	}
+}
 
-void measure(std::function<bool(unsigned long long)> test, std::string what) {
-    auto start = std::chrono::system_clock::now();
-    for (unsigned long long i = 0; i < 10'000'000; ++i)
-    	test(i);
-    auto stop = std::chrono::system_clock::now();
-    std::chrono::duration<double, std::milli> time = stop - start;
-    std::cout << time.count() << "ms for " << what << std::endl;
+// the engines over whole ranges, with the primes found as the items
+void bench_sieves(Harness& harness, unsigned hardware) {
+	// the primes per second by the number of threads, in powers of two up to the hardware
+	std::vector<unsigned> threads;
+	for (unsigned each = 1; each < hardware; each *= 2) threads.push_back(each);
+	threads.push_back(hardware);
+	for (uintmax_t below : {100'000'000ull, 1'000'000'000ull}) {
+		std::string input = "below_" + std::to_string(below);
+		for (unsigned each : threads) {
+			std::string suffix = each == 1 ? "" : "_" + std::to_string(each) + "_threads";
+			harness.run("sieve_count" + suffix, input, 0, 5, [&] {
+				return SievePrimeEngine(each).count_below(below);
+			});
+			harness.run("sieve_collect" + suffix, input, 0, 5, [&] {
+				SievePrimeEngine engine(each);
+				engine.computeBelow(below);
+				return std::lower_bound(engine.get_primes().begin(), engine.get_primes().end(), below) - engine.get_primes().begin();
+			});
+		}
+		harness.run("prime_range", input, 0, 5, [&] {
+			size_t count = 0;
+			for (uint64_t p : PrimeRange(0, below)) count += p != 0;
+			return count;
+		});
+	}
+	constexpr uint64_t offset = 1'000'000'000'000'000;
+	harness.run("prime_range", "10^15_plus_10^8", 0, 5, [&] {
+		size_t count = 0;
+		for (uint64_t p : PrimeRange(offset, offset + 100'000'000)) count += p != 0;
+		return count;
+	});
+	// the numbers sieved as the items and the peak bytes held as the value
+	for (uintmax_t L = 1'000'000; L <= 1'000'000'000; L *= 10) {
+		harness.run("linear_sieve", "up_to_" + std::to_string(L), L, L < 1'000'000'000 ? 5 : 1, [&] {
+			return LinearPrimeEngine(L).peak_memory;
+		});
+	}
+	// pi(x) by Meissel-Lehmer against counting the sieve, which takes minutes past 10^10 and is left out there
+	for (uint64_t x = 1'000'000'000; x <= 1'000'000'000'000; x *= 10) {
+		std::string input = "up_to_" + std::to_string(x);
+		harness.run("prime_count", input, 0, 5, [&] {
+			return yao_math::prime_count(x, hardware);
+		});
+		if (x <= 10'000'000'000) {
+			harness.run("sieve_count", input, 0, 3, [&] {
+				return SievePrimeEngine(hardware).count_below(x + 1);
+			});
+		}
+	}
 }
 
-int main() {
-	measure(is_prime_odd, "is_prime_odd");
-	measure(is_prime_even, "is_prime_even");
-	measure(is_prime_hexa, "is_prime_hexa");
-}
\ No newline at end of file
+/* prime-benchmark [--csv | --json] [--quick] [--filter name]
+ * prints the table as the benchmarks go, or only the CSV or JSON at the end;
+ * --quick takes 3 repetitions at most and --filter the benchmarks whose name contains it
+ */
+int main(int argc, char** argv) {
+	Harness::format_t format = Harness::table;
+	bool quick = false;
+	std::string filter;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if (arg == "--csv") format = Harness::csv;
+		else if (arg == "--json") format = Harness::json;
+		else if (arg == "--quick") quick = true;
+		else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+		else {
+			std::cerr << "usage: " << argv[0] << " [--csv | --json] [--quick] [--filter name]" << std::endl;
+			return 1;
+		}
+	}
+	Harness harness(format, quick, filter);
+	bench_tests(harness);
+	bench_sieves(harness, std::max(std::thread::hardware_concurrency(), 1u));
+	harness.print(std::cout);
+}
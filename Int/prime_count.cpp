@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <bit>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+
+#include "sieve_prime.cpp"
+#include "factor.cpp"
+
+#ifndef YAO_MATH_PRIME_COUNT
+#define YAO_MATH_PRIME_COUNT
+
+namespace yao_math {
+
+namespace counting {
+
+// phi(x, 6) = x / 30030 * 5760 + phi_table[x % 30030] for the numbers coprime to 2 * 3 * 5 * 7 * 11 * 13
+constexpr size_t PHI_PRIMES = 6;
+constexpr uint32_t PHI_PRIMORIAL = 30030, PHI_TOTIENT = 5760;
+
+constexpr auto phi_table = [] {
+    std::array<uint16_t, PHI_PRIMORIAL> ret{};
+    uint16_t count = 0;
+    for (uint32_t r = 0; r < PHI_PRIMORIAL; ++r) {
+        count += r % 2 && r % 3 && r % 5 && r % 7 && r % 11 && r % 13;
+        ret[r] = count;
+    }
+    return ret;
+}();
+
+constexpr uint64_t phi_tiny(uint64_t x) noexcept {
+    return x / PHI_PRIMORIAL * PHI_TOTIENT + phi_table[x % PHI_PRIMORIAL];
+}
+
+// pi(v) for v below the limit, from the wheel bitmap of SievePrimeEngine and a running count per word
+class pi_table {
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> counts;
+    // the bits of a byte whose numbers are up to 30 * i + r
+    std::array<uint8_t, 30> up_to{};
+
+public:
+    pi_table(SievePrimeEngine& engine, uint64_t limit) : words(engine.bitmap(limit)), counts(words.size()) {
+        uint32_t count = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            counts[i] = count;
+            count += std::popcount(words[i]);
+        }
+        for (unsigned r = 0; r < 30; ++r) {
+            for (unsigned k = 0; k < 8; ++k)
+                if (SievePrimeEngine::bitmap_number(0, k) <= r) up_to[r] |= uint8_t(1u << k);
+        }
+    }
+
+    uint64_t operator()(uint64_t v) const noexcept {
+        // 2, 3 and 5 are off the wheel
+        if (v < 7) return v < 2 ? 0 : v < 3 ? 1 : v < 5 ? 2 : 3;
+        uint64_t byte = v / 30, shift = 8 * (byte % 8);
+        uint64_t mask = ((uint64_t(1) << shift) - 1) | (uint64_t(up_to[v % 30]) << shift);
+        return 3 + counts[byte / 8] + std::popcount(words[byte / 8] & mask);
+    }
+};
+
+/*
+ * phi(x, a), the count of the numbers up to x with no prime factor among the first a,
+ * by phi(x, a) = phi(x, 6) - sum of phi(x / p_i, i - 1) for 6 < i <= a, where
+ * phi(x / p_i, i - 1) = 1 once p_i^2 > x, and phi(x, a) = pi(x) - a + 1 once x < p_a+1^2;
+ * primes[i] is p_i from 1 on, and pi covers the x below the square of p_a
+ */
+struct phi_context {
+    std::vector<uint32_t> const& primes;
+    pi_table const& pi;
+
+    uint64_t operator()(uint64_t x, size_t a) const noexcept {
+        if (a <= PHI_PRIMES) return phi_tiny(x);
+        uint64_t next = primes[a + 1];
+        if (x < next * next) return x ? std::max<int64_t>(int64_t(pi(x)) - int64_t(a) + 1, 1) : 0;
+        uint64_t ret = phi_tiny(x);
+        for (size_t i = PHI_PRIMES + 1; i <= a; ++i) {
+            uint64_t p = primes[i];
+            if (p * p > x) {
+                // each one left is 1 as long as p_i <= x
+                uint64_t last = std::min<uint64_t>(a, pi(x));
+                if (last >= i) ret -= last - i + 1;
+                break;
+            }
+            ret -= (*this)(x / p, i - 1);
+        }
+        return ret;
+    }
+};
+
+inline uint64_t icbrt(uint64_t n) noexcept {
+    uint64_t r = uint64_t(std::cbrt(double(n)));
+    while (r * r * r > n) --r;
+    while ((r + 1) * (r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+}
+
+/*
+ * pi(x), the count of the primes up to x, by Meissel-Lehmer:
+ * with y = x^(1/3) and a = pi(y), pi(x) = phi(x, a) + a - 1 - P2(x, a), where
+ * P2 counts the products of two primes above y up to x as the sum of
+ * pi(x / p) - pi(p) + 1 for y < p <= x^(1/2); SievePrimeEngine sieves up to x / y
+ * for the pi lookups, and the top terms of phi(x, a) go to its threads in turn
+ */
+inline uint64_t prime_count(uint64_t x, unsigned threads = 1) {
+    using namespace counting;
+    SievePrimeEngine engine(threads);
+    // too small for a = pi(y) to be past the table of phi
+    if (x < 1 << 16) return engine.count_below(x + 1);
+    if (x >> 53) throw std::invalid_argument(std::to_string(x) + " is too large to count up to");
+    threads = engine.get_threads();
+    uint64_t y = icbrt(x), root = factoring::isqrt(x);
+    pi_table pi(engine, x / y + 1);
+    engine.computeBelow(root + 1);
+    std::vector<uint32_t> primes = {0};
+    for (uintmax_t p : engine.get_primes()) {
+        if (p > root) break;
+        primes.push_back(uint32_t(p));
+    }
+    size_t a = pi(y), b = primes.size() - 1;
+    phi_context phi{primes, pi};
+
+    // the top terms one at a time, as their costs are far apart
+    std::vector<uint64_t> sums(threads);
+    std::atomic<size_t> next = PHI_PRIMES + 1;
+    auto work = [&](unsigned t) {
+        for (size_t i; (i = next++) <= a;) sums[t] += phi(x / primes[i], i - 1);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto& thread : pool) thread.join();
+    uint64_t phi_x = phi_tiny(x);
+    for (uint64_t sum : sums) phi_x -= sum;
+
+    uint64_t p2 = 0;
+    for (size_t i = a + 1; i <= b; ++i) p2 += pi(x / primes[i]) - (i - 1);
+    return phi_x + a - 1 - p2;
+}
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#include "prime_count.cpp"
+
+#include <iostream>
+using namespace std;
+
+using namespace yao_math;
+
+static_assert(counting::phi_tiny(30030) == 5760 && counting::phi_tiny(17) == 2);
+
+int main() {
+    // pi(10^k) from k = 0 on
+    constexpr uint64_t expected[] = {0, 4, 25, 168, 1229, 9592, 78498, 664579, 5761455, 50847534, 455052511, 4118054813};
+    bool failed = false;
+    uint64_t x = 1;
+    for (uint64_t count : expected) {
+        uint64_t got = prime_count(x, 4);
+        cout << "pi(" << x << ") = " << got << endl;
+        failed |= got != count;
+        x *= 10;
+    }
+    SievePrimeEngine engine;
+    for (uint64_t x : {65535, 65536, 65537, 999983, 1000003, 123456789}) {
+        failed |= prime_count(x) != engine.count_below(x + 1);
+    }
+    return failed;
+}
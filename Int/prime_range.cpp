@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <bit>
+#include <iterator>
+#include <ranges>
+#include <algorithm>
+#include <initializer_list>
+
+#include "sieve_prime.cpp"
+#include "factor.cpp"
+
+#ifndef YAO_MATH_PRIME_RANGE
+#define YAO_MATH_PRIME_RANGE
+
+/*
+ * the primes in [first, last) as a lazy input range, sieved one segment of
+ * the wheel of SievePrimeEngine at a time from first on, so that nothing
+ * below first is sieved and only a segment and the sieving primes up to the
+ * square root of its end are held at once, about 24 bytes each
+ */
+class PrimeRange {
+    using Engine = SievePrimeEngine;
+
+    // the sieving primes stay below 2^32 and their multiples within 64 bits
+    constexpr static uint64_t LIMIT = UINT64_MAX - (uint64_t(1) << 40);
+
+    /* the multiples of 7, 11 and 13 repeat on the wheel every 7 * 11 * 13 bytes,
+     * so each segment starts as a copy of them, and the sieving goes from 17 on
+     */
+    constexpr static size_t PATTERN_BYTES = 7 * 11 * 13;
+    constexpr static size_t PRESIEVED = 6;
+    constexpr static auto pattern = [] {
+        std::array<uint8_t, PATTERN_BYTES> ret{};
+        for (uint64_t i = 0; i < PATTERN_BYTES; ++i) {
+            for (unsigned k = 0; k < 8; ++k) {
+                uint64_t n = Engine::bitmap_number(i, k);
+                if (n % 7 && n % 11 && n % 13) ret[i] |= uint8_t(1u << k);
+            }
+        }
+        return ret;
+    }();
+
+    uint64_t first, last;
+
+public:
+    class iterator {
+        uint64_t last = 0, value = 0;
+        // the primes to sieve by, from 17 on
+        Engine small;
+        std::vector<Engine::SievingPrime> sieving;
+        size_t known = PRESIEVED;
+        std::vector<uint8_t> segment;
+        // the bytes [low, high) of the segment out of those below end
+        uint64_t low = 0, high = 0, end = 0;
+        // the byte of value and its bits from value on
+        uint64_t byte = 0;
+        unsigned bits = 0;
+        bool done = true;
+
+        void load(uint64_t from) {
+            low = from;
+            high = std::min<uint64_t>(from + Engine::SEGMENT_BYTES, end);
+            size_t size = high - low;
+            uint64_t top = 30 * high, root = yao_math::factoring::isqrt(top);
+            small.computeBelow(root + 1);
+            auto const& primes = small.get_primes();
+            for (; known < primes.size() && primes[known] * primes[known] < top; ++known)
+                sieving.push_back(Engine::sieving_prime(primes[known], low));
+            segment.resize(size);
+            for (size_t i = 0, offset = low % PATTERN_BYTES; i < size;) {
+                size_t count = std::min(size - i, PATTERN_BYTES - offset);
+                std::copy_n(pattern.begin() + offset, count, segment.begin() + i);
+                i += count;
+                offset = 0;
+            }
+            // 7, 11 and 13 themselves are primes, and 1 is not
+            if (!low) segment[0] = uint8_t(segment[0] | 0b1110) & uint8_t(~1u);
+            Engine::cross_off(segment.data(), low, size, sieving);
+            if (high == end) {
+                for (unsigned k = 0; k < 8; ++k)
+                    if (Engine::bitmap_number(high - 1, k) >= last) segment[size - 1] &= uint8_t(~(1u << k));
+            }
+        }
+
+        // goes on from the bits of byte to the first set one
+        void settle() {
+            while (!bits) {
+                if (++byte == high) {
+                    if (high == end) {
+                        done = true;
+                        return;
+                    }
+                    load(high);
+                }
+                bits = segment[byte - low];
+            }
+            value = Engine::bitmap_number(byte, std::countr_zero(bits));
+        }
+
+        // the wheel from first on, where first >= 7
+        void start(uint64_t first) {
+            if (first >= last) return;
+            done = false;
+            end = last / 30 + (last % 30 != 0);
+            load(first / 30);
+            byte = low;
+            bits = segment[0];
+            for (unsigned k = 0; k < 8; ++k)
+                if (Engine::bitmap_number(byte, k) < first) bits &= ~(1u << k);
+            settle();
+        }
+
+    public:
+        using value_type = uint64_t;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        iterator(uint64_t first, uint64_t last) : last(std::min(last, LIMIT)) {
+            // 2, 3 and 5 are off the wheel
+            for (uint64_t p : {2, 3, 5}) {
+                if (p >= first && p < this->last) {
+                    value = p;
+                    done = false;
+                    return;
+                }
+            }
+            start(std::max<uint64_t>(first, 7));
+        }
+
+        uint64_t operator*() const {
+            return value;
+        }
+
+        iterator& operator++() {
+            if (value < 7) {
+                for (uint64_t p : {3, 5}) {
+                    if (p > value && p < last) {
+                        value = p;
+                        return *this;
+                    }
+                }
+                done = true;
+                start(7);
+                return *this;
+            }
+            bits &= bits - 1;
+            settle();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return done;
+        }
+    };
+
+    // last is taken down to 2^64 - 2^40
+    explicit PrimeRange(uint64_t first, uint64_t last = LIMIT) : first(first), last(last) {}
+
+    iterator begin() const {
+        return iterator(first, last);
+    }
+
+    std::default_sentinel_t end() const {
+        return {};
+    }
+};
+
+static_assert(std::input_iterator<PrimeRange::iterator>);
+static_assert(std::ranges::input_range<PrimeRange>);
+
+#endif
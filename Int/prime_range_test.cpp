@@ -0,0 +1,37 @@
+#include "prime_range.cpp"
+#include "primality.cpp"
+
+#include <iostream>
+using namespace std;
+
+int main() {
+    bool failed = false;
+    // from 0 against the sieve
+    SievePrimeEngine engine;
+    engine.computeBelow(10'000'000);
+    size_t count = 0;
+    for (uint64_t p : PrimeRange(0, 10'000'000)) failed |= p != engine.get_primes()[count++];
+    cout << count << " primes below 10^7" << endl;
+    failed |= count != 664579;
+    // from an offset without sieving from 0, against Miller-Rabin
+    constexpr uint64_t low = 1'000'000'000'000'000, high = low + 1'000'000;
+    auto it = PrimeRange(low, high).begin();
+    count = 0;
+    for (uint64_t n = low; n < high; ++n) {
+        if (!yao_math::is_prime(n)) continue;
+        failed |= it == default_sentinel || *it != n;
+        ++it, ++count;
+    }
+    failed |= it != default_sentinel;
+    cout << count << " primes in [10^15, 10^15 + 10^6)" << endl;
+    // the ends
+    for (uint64_t first = 0; first < 40; ++first) {
+        for (uint64_t last = first; last < 40; ++last) {
+            vector<uint64_t> got, expected;
+            ranges::copy(PrimeRange(first, last), back_inserter(got));
+            for (uint64_t n = first; n < last; ++n) if (yao_math::is_prime(n)) expected.push_back(n);
+            failed |= got != expected;
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,258 @@
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "int_base.cpp"
+#include "limb.cpp"
+
+#ifndef YAO_MATH_RADIX
+#define YAO_MATH_RADIX
+
+// conversion between limb arrays and digit strings in any base from 2 to 36
+namespace yao_math::radix {
+
+// below these sizes the conversion goes chunk by chunk, above them it splits
+// the number at a power of the base and converts both halves recursively
+constexpr size_t TO_CHARS_THRESHOLD = 24;     // in limbs
+constexpr size_t FROM_CHARS_THRESHOLD = 800;  // in digits
+
+// the largest power of base fitting in a limb, i.e. 10^19 for 64-bit limbs in decimal,
+// with its reciprocal for the repeated divisions
+template<typename L>
+struct chunk {
+    L power;
+    size_t digits;
+    limb::inverse<L> inverse;
+
+    constexpr explicit chunk(int base) noexcept : power(largest_power(base)), digits(count(base)), inverse(power) {}
+
+private:
+    static constexpr L largest_power(int base) noexcept {
+        L power = L(base);
+        while (power <= L(~L(0) / L(base))) power *= L(base);
+        return power;
+    }
+
+    static constexpr size_t count(int base) noexcept {
+        size_t digits = 1;
+        for (L power = L(base); power <= L(~L(0) / L(base)); power *= L(base)) ++digits;
+        return digits;
+    }
+};
+
+// the decimal chunk is a constant, reciprocal included
+template<typename L>
+constexpr chunk<L> decimal_chunk{10};
+
+// log2(base) if base is a power of two, otherwise 0
+constexpr unsigned pow2_bits(int base) noexcept {
+    return std::has_single_bit(unsigned(base)) ? std::countr_zero(unsigned(base)) : 0;
+}
+
+// an upper bound of the number of digits of a number with the given bits
+constexpr size_t max_digits(size_t bits, int base) noexcept {
+    if (unsigned k = pow2_bits(base)) return std::max<size_t>(1, (bits + k - 1) / k);
+    return bits / (std::bit_width(unsigned(base)) - 1) + 1;
+}
+
+// an upper bound of the number of limbs of a number with the given digits
+template<typename L>
+constexpr size_t max_limbs(size_t digits, int base) noexcept {
+    return digits * std::bit_width(unsigned(base - 1)) / limb::bits<L> + 1;
+}
+
+// powers[k] = chunk.power ^ (2 ^ k) which has digits[k] = chunk.digits << k zeros
+template<typename L>
+struct power_table {
+    std::vector<std::vector<L>> powers;
+    std::vector<size_t> digits;
+
+    // squares up until the power reaches half of n limbs
+    constexpr power_table(chunk<L> c, size_t n) : powers{{c.power}}, digits{c.digits} {
+        while (powers.back().size() * 2 <= n) {
+            auto const& p = powers.back();
+            size_t m = p.size();
+            std::vector<L> sq(2 * m), scratch(limb::mul_scratch(m) + 1);
+            limb::mul_n(sq.data(), p.data(), p.data(), m, scratch.data());
+            while (!sq.back()) sq.pop_back();
+            powers.push_back(std::move(sq));
+            digits.push_back(digits.back() * 2);
+        }
+    }
+};
+
+// writes the digits of a backwards ending at last, padded with zeros to at
+// least width digits; a is destroyed
+template<typename L, typename B>
+constexpr char* to_chars_basecase(char* last, L* a, size_t n, size_t width,
+                                  chunk<L> const& c, B base, bool uppercase) noexcept {
+    char* first = last;
+    while (n && !a[n - 1]) --n;
+    while (n) {
+        L rem = limb::divrem_1(a, a, n, c.inverse);
+        if (!a[n - 1]) --n;
+        // the last chunk stops at its leading digit, the others are full
+        for (size_t i = 0; i < c.digits && (n || rem); ++i) {
+            *--first = int_base::to_char_raw(int(rem % L(base)), base, uppercase);
+            rem /= L(base);
+        }
+    }
+    while (size_t(last - first) < std::max<size_t>(width, 1)) *--first = '0';
+    return first;
+}
+
+// decimal takes a constant base so that the digits are split without division
+template<typename L>
+constexpr char* to_chars_basecase(char* last, L* a, size_t n, size_t width,
+                                  chunk<L> const& c, int base, bool uppercase) noexcept {
+    if (base == 10) return to_chars_basecase(last, a, n, width, c, std::integral_constant<int, 10>{}, uppercase);
+    return to_chars_basecase<L, int>(last, a, n, width, c, base, uppercase);
+}
+
+template<typename L>
+constexpr char* to_chars_dc(char* last, L* a, size_t n, size_t width, power_table<L> const& table,
+                            size_t k, chunk<L> const& c, int base, bool uppercase) {
+    while (n && !a[n - 1]) --n;
+    if (n < TO_CHARS_THRESHOLD) return to_chars_basecase(last, a, n, width, c, base, uppercase);
+    // the divisor takes about half of the limbs and must not exceed the number
+    while (k && (table.powers[k].size() > (n + 1) / 2
+              || limb::cmp(a, n, table.powers[k].data(), table.powers[k].size()) < 0)) --k;
+    auto const& p = table.powers[k];
+    size_t pn = p.size();
+    std::vector<L> q(n - pn + 1), r(pn), scratch(limb::divrem_scratch(n, pn));
+    limb::divrem(q.data(), r.data(), a, n, p.data(), pn, scratch.data());
+    size_t low = table.digits[k];
+    char* mid = to_chars_dc(last, r.data(), pn, low, table, k, c, base, uppercase);
+    return to_chars_dc(mid, q.data(), q.size(), width > low ? width - low : 0, table, k, c, base, uppercase);
+}
+
+// power-of-two bases slice k bits per digit
+template<typename L>
+constexpr char* to_chars_pow2(char* last, const L* a, size_t n, unsigned k, bool uppercase) noexcept {
+    constexpr size_t BITS = limb::bits<L>;
+    while (n && !a[n - 1]) --n;
+    size_t bits = n ? (n - 1) * BITS + std::bit_width(a[n - 1]) : 0;
+    size_t count = std::max<size_t>(1, (bits + k - 1) / k);
+    L mask = L(~L(0)) >> (BITS - k);
+    for (size_t i = 0; i < count; ++i) {
+        size_t pos = i * k, j = pos / BITS, off = pos % BITS;
+        L d = a[j] >> off;
+        if (off + k > BITS && j + 1 < n) d |= a[j + 1] << (BITS - off);
+        *--last = int_base::to_char_raw(int(d & mask), 1 << k, uppercase);
+    }
+    return last;
+}
+
+// writes the digits of the n-limb a backwards ending at last and returns the
+// first digit, at most max_digits(n * bits<L>, base) are written; a is destroyed
+template<typename L>
+constexpr char* to_chars(char* last, L* a, size_t n, int base, bool uppercase = false) {
+    if (unsigned k = pow2_bits(base)) return to_chars_pow2(last, a, n, k, uppercase);
+    while (n && !a[n - 1]) --n;
+    chunk<L> c = base == 10 ? decimal_chunk<L> : chunk<L>(base);
+    if (n < TO_CHARS_THRESHOLD) return to_chars_basecase(last, a, n, 0, c, base, uppercase);
+    power_table<L> table(c, n);
+    return to_chars_dc(last, a, n, 0, table, table.powers.size() - 1, c, base, uppercase);
+}
+
+// r = the value of the digits in [first, last), r has max_limbs(last - first, base) limbs,
+// returns the number of significant limbs
+template<typename L>
+constexpr size_t from_chars_basecase(L* r, const char* first, const char* last, chunk<L> c, int base) noexcept {
+    size_t n = 0;
+    // the leading partial chunk makes all the others full
+    size_t head = size_t(last - first) % c.digits;
+    if (!head) head = c.digits;
+    while (first != last) {
+        L value = 0, power = 1;
+        for (const char* end = first + head; first != end; ++first) {
+            value = value * L(base) + L(int_base::from_char_raw(*first, base));
+            power *= L(base);
+        }
+        head = c.digits;
+        if (n) {
+            if (L carry = limb::mul_1(r, r, n, power)) r[n++] = carry;
+            if (limb::add_1(r, r, n, value)) r[n++] = 1;
+        } else if (value) {
+            r[n++] = value;
+        }
+    }
+    return n;
+}
+
+template<typename L>
+constexpr size_t from_chars_dc(L* r, const char* first, const char* last, power_table<L> const& table,
+                               size_t k, chunk<L> c, int base) {
+    size_t len = last - first;
+    if (len < FROM_CHARS_THRESHOLD) return from_chars_basecase(r, first, last, c, base);
+    // the low part takes about half of the digits
+    while (k && table.digits[k] * 2 > len) --k;
+    const char* mid = last - table.digits[k];
+    std::vector<L> high(max_limbs<L>(mid - first, base)), low(max_limbs<L>(last - mid, base));
+    size_t hn = from_chars_dc(high.data(), first, mid, table, k, c, base);
+    size_t ln = from_chars_dc(low.data(), mid, last, table, k, c, base);
+    auto const& p = table.powers[k];
+    size_t pn = p.size();
+    size_t n = 0;
+    if (hn) {
+        // high * power + low, the product is only sized by its operands
+        std::vector<L> prod(hn + pn);
+        if (hn >= pn) {
+            std::vector<L> scratch(limb::mul_scratch(hn, pn) + 1);
+            limb::mul(prod.data(), high.data(), hn, p.data(), pn, scratch.data());
+        } else {
+            std::vector<L> scratch(limb::mul_scratch(pn, hn) + 1);
+            limb::mul(prod.data(), p.data(), pn, high.data(), hn, scratch.data());
+        }
+        limb::add_to(prod.data(), prod.size(), low.data(), ln);
+        n = prod.size();
+        while (n && !prod[n - 1]) --n;
+        limb::copy_n(r, prod.data(), n);
+    } else {
+        n = ln;
+        limb::copy_n(r, low.data(), n);
+    }
+    return n;
+}
+
+// power-of-two bases place k bits per digit, digits beyond rn limbs are dropped
+template<typename L>
+constexpr void from_chars_pow2(L* r, size_t rn, const char* first, const char* last, unsigned k) noexcept {
+    constexpr size_t BITS = limb::bits<L>;
+    limb::zero_n(r, rn);
+    for (size_t pos = 0; last != first && pos < rn * BITS; pos += k) {
+        L d = int_base::from_char_raw(*--last, 1 << k);
+        size_t j = pos / BITS, off = pos % BITS;
+        r[j] |= d << off;
+        if (off + k > BITS && j + 1 < rn) r[j + 1] |= d >> (BITS - off);
+    }
+}
+
+// r = the value of the digits in [first, last) modulo 2^(rn * bits<L>),
+// the digits must be valid in base
+template<typename L>
+constexpr void from_chars(L* r, size_t rn, const char* first, const char* last, int base) {
+    if (unsigned k = pow2_bits(base)) return from_chars_pow2(r, rn, first, last, k);
+    // leading zeros contribute nothing but the length
+    while (first != last && *first == '0') ++first;
+    size_t m = max_limbs<L>(last - first, base);
+    std::vector<L> buf(m);
+    chunk<L> c = base == 10 ? decimal_chunk<L> : chunk<L>(base);
+    size_t n;
+    if (size_t(last - first) < FROM_CHARS_THRESHOLD) {
+        n = from_chars_basecase(buf.data(), first, last, c, base);
+    } else {
+        power_table<L> table(c, m);
+        n = from_chars_dc(buf.data(), first, last, table, table.powers.size() - 1, c, base);
+    }
+    n = std::min(n, rn);
+    limb::copy_n(r, buf.data(), n);
+    limb::zero_n(r + n, rn - n);
+}
+
+}
+
+#endif
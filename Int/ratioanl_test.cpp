@@ -1,6 +1,8 @@
 #include "rational.cpp"
+#include "big_int.cpp"
 
 #include <iostream>
+#include <cstdint>
 
 using namespace std;
 
@@ -9,8 +11,81 @@ using namespace yao_math;
 
 constexpr Rational<int> a{1, 2}, b{3, 4};
 static_assert(a / b == Rational<int>{2, 3});
+static_assert(a - b == Rational<int>{-1, 4} && (a - b).inverse() == Rational<int>{-4} && abs(a - b) == Rational<int>{1, 4});
 
+// the cross cancellation keeps the products within 64 bits
+constexpr int64_t big = int64_t(1) << 62;
+static_assert(Rational<int64_t>(big, 3) * Rational<int64_t>(3, big) == Rational<int64_t>(1));
+static_assert(Rational<int64_t>(big - 1, 3) / Rational<int64_t>(big - 1, 6) == Rational<int64_t>(2));
+static_assert(Rational<int64_t>(1, big) + Rational<int64_t>(1, big) == Rational<int64_t>(1, big / 2));
+static_assert(Rational<int64_t>(5, big / 2 * 3) - Rational<int64_t>(1, big / 2) == Rational<int64_t>(1, big / 4 * 3));
+// the comparison widens past 64 bits, or goes by the continued fractions without a wider type
+static_assert(Rational<int64_t>(big - 1, big) < Rational<int64_t>(big + 1, big + 2));
+static_assert(Rational<__int128>(__int128(big) * big - 1, __int128(big) * big) < Rational<__int128>(__int128(big) * big + 1, __int128(big) * big + 2));
+static_assert(Rational<__int128>(-7, 3) < Rational<__int128>(-9, 4) && Rational<__int128>(22, 7) > Rational<__int128>(333, 106));
+
+// the harmonic number H_30 accumulated in place
+static_assert([] {
+    Rational<int64_t> h;
+    for (int64_t i = 1; i <= 30; ++i) h += Rational<int64_t>(1, i);
+    return h == Rational<int64_t>(9304682830147, 2329089562800);
+}());
+static_assert([] {
+    Rational<sint256> h;
+    for (int i = 1; i <= 30; ++i) h += Rational<sint256>(1, i);
+    return h == Rational<sint256>(9304682830147, 2329089562800) && h > Rational<sint256>(3) && -h < Rational<sint256>(-3);
+}());
+
+// the lazy sums agree with the eager ones, reducing only when the products would overflow
+static_assert([] {
+    LazyRational<int64_t> h;
+    for (int64_t i = 1; i <= 30; ++i) h += LazyRational<int64_t>(1, i);
+    return h.reduced() == Rational<int64_t>(9304682830147, 2329089562800) && h > LazyRational<int64_t>(3);
+}());
+static_assert([] {
+    Rational<int64_t> terms[1000];
+    for (int64_t i = 0; i < 1000; ++i) terms[i] = Rational<int64_t>(i % 7 - 3, i % 16 + 1);
+    Rational<int64_t> eager;
+    for (auto const& each : terms) eager += each;
+    return sum<int64_t>(terms) == eager;
+}());
+static_assert([] {
+    LazyRational<big_int> h;
+    for (int i = 1; i <= 100; ++i) h += LazyRational<big_int>(1, i);
+    Rational<big_int> eager;
+    for (int i = 1; i <= 100; ++i) eager += Rational<big_int>(1, i);
+    return h.reduced() == eager && h == LazyRational<big_int>(eager) && LazyRational<sint128>(6, 4) == LazyRational<sint128>(-3, -2);
+}());
+
+// the doubles exactly, and their closest fractions by the convergents and semiconvergents
+static_assert(Rational<int64_t>::from_double(0.75) == Rational<int64_t>(3, 4) && Rational<int>::from_double(-0.0) == Rational<int>());
+static_assert(Rational<int64_t>::from_double(-1e18) == Rational<int64_t>(-1'000'000'000'000'000'000));
+// a negative value has no unsigned numerator, which from_double throws for
+static_assert(!rationals::fits<uint64_t>(rationals::split(-0.75)) && !rationals::fits<uint256>(rationals::split(-2.0)));
+static_assert(rationals::fits<uint64_t>(rationals::split(-0.0)) && Rational<uint64_t>::from_double(0.75) == Rational<uint64_t>(3, 4));
+static_assert(Rational<sint256>::from_double(0x1p-200) == Rational<sint256>(sint256(1), sint256(1) << 200));
+static_assert(best_approximation(3.141592653589793, int64_t(1000)) == Rational<int64_t>(355, 113));
+static_assert(best_approximation(3.141592653589793, int64_t(100)) == Rational<int64_t>(311, 99));
+static_assert(best_approximation(3.141592653589793, int64_t(7)) == Rational<int64_t>(22, 7));
+static_assert(best_approximation(-0.1, int64_t(1'000'000'000'000)) == Rational<int64_t>(-1, 10));
+static_assert(best_approximation(1e-300, int64_t(1'000'000)) == Rational<int64_t>());
+static_assert(best_approximation(Rational<sint256>(415, 93), int64_t(10)) == Rational<int64_t>(40, 9));
+// 1 / 2 and 2 / 3 are as close to 7 / 12 as the denominator 3 gets, and the tie goes to the convergent 1 / 2
+static_assert(best_approximation(Rational<int>(7, 12), 3) == Rational<int>(1, 2));
+static_assert([] {
+    int64_t partials[] = {4, 2, 6, 7}, i = 0;
+    for (int64_t a : ContinuedFraction(Rational<int64_t>(415, 93))) if (i == 4 || a != partials[i++]) return false;
+    Rational<int64_t> convergents[] = {{4}, {9, 2}, {58, 13}, {415, 93}};
+    i = 0;
+    for (auto x : Convergents(Rational<int64_t>(415, 93))) if (i == 4 || x != convergents[i++]) return false;
+    return i == 4;
+}());
+static_assert(*ContinuedFraction(Rational<int>(-7, 3)).begin() == -3);
 
 int main() {
     cout << toTex(a / b) << endl;
+    try {
+        Rational<uint64_t>::from_double(-0.75);
+        return 1;
+    } catch (overflow_error const&) {}
 }
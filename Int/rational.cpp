@@ -1,7 +1,20 @@
 #include <stdexcept>
 #include <cmath>
 #include <compare>
+#include <numeric>
+#include <concepts>
+#include <type_traits>
+#include <limits>
+#include <bit>
+#include <span>
+#include <iterator>
+#include <utility>
+#include <ranges>
 #include "../yao_math.h"
+#include "wide_int.cpp"
+
+#ifndef YAO_MATH_RATIONAL
+#define YAO_MATH_RATIONAL
 
 namespace yao_math {
 class BadRational : public std::domain_error {
@@ -9,20 +22,219 @@ public:
     explicit BadRational() : std::domain_error("bad rational: zero denominator") {}
 };
 
+namespace rationals {
+
+// holds the product of two IntType for the comparison, void when none is wider, and IntType itself when unbounded
+template<typename IntType>
+struct widened {
+    using type = IntType;
+};
+
+template<std::integral IntType> requires (sizeof(IntType) < 8)
+struct widened<IntType> {
+    using type = std::conditional_t<std::is_signed_v<IntType>, int64_t, uint64_t>;
+};
+
+template<std::integral IntType> requires (sizeof(IntType) == 8)
+struct widened<IntType> {
+    using type = std::conditional_t<std::is_signed_v<IntType>, __int128, unsigned __int128>;
+};
+
+template<std::integral IntType> requires (sizeof(IntType) > 8)
+struct widened<IntType> {
+    using type = void;
+};
+
+template<size_t N, bool S>
+struct widened<wide_int<N, S>> {
+    using type = wide_int<2 * N, S>;
+};
+
+template<typename T>
+constexpr std::strong_ordering order(T const& x, T const& y) {
+    if constexpr (std::three_way_comparable<T, std::strong_ordering>) return x <=> y;
+    else return x < y ? std::strong_ordering::less : y < x ? std::strong_ordering::greater : std::strong_ordering::equal;
+}
+
+template<typename T>
+constexpr T magnitude(T const& x) {
+    if constexpr (requires { x.abs(); }) {
+        return x.abs();
+    } else {
+        using std::abs;
+        return abs(x);
+    }
+}
+
+template<typename T>
+constexpr T gcd_of(T const& x, T const& y) {
+    using std::gcd;
+    return T(gcd(x, y));
+}
+
+// the bits of the magnitude
+template<typename T>
+constexpr size_t width(T const& x) {
+    if constexpr (std::integral<T>) {
+        using U = std::make_unsigned_t<T>;
+        return std::bit_width(x < T(0) ? U(0) - U(x) : U(x));
+    } else {
+        return magnitude(x).bit_width();
+    }
+}
+
+// the bits an IntType holds besides the sign, 0 for the unbounded ones
+template<typename T>
+constexpr size_t capacity = 0;
+
+template<std::integral T>
+constexpr size_t capacity<T> = std::numeric_limits<T>::digits;
+
+template<size_t N, bool S>
+constexpr size_t capacity<wide_int<N, S>> = S ? N - 1 : N;
+
+// whether an IntType holds no negative numbers
+template<typename T>
+constexpr bool unsigned_only = false;
+
+template<std::integral T>
+constexpr bool unsigned_only<T> = std::is_unsigned_v<T>;
+
+template<size_t N, bool S>
+constexpr bool unsigned_only<wide_int<N, S>> = !S;
+
+// the quotient and remainder of a / b by the floor for b > 0, so that the remainder is in [0, b)
+template<typename T>
+struct floor_div_t {
+    T quot, rem;
+};
+
+template<typename T>
+constexpr floor_div_t<T> floor_div(T const& a, T const& b) {
+    T q = a / b, r = a % b;
+    if (r < T(0)) q -= T(1), r += b;
+    return {std::move(q), std::move(r)};
+}
+
+// between the IntTypes, where wide_int goes to the integral types only by to_integral
+template<typename To, typename From>
+constexpr To convert(From const& x) {
+    if constexpr (std::is_constructible_v<To, From const&>) return To(x);
+    else return x.template to_integral<To>();
+}
+
+/*
+ * a / b <=> c / d for b, d > 0 without any product, by the continued fractions:
+ * the floors decide unless equal, and then r / b <=> t / d of the remainders is d / t <=> b / r
+ */
+template<typename T>
+constexpr std::strong_ordering euclid_order(T a, T b, T c, T d) {
+    while (true) {
+        auto [q, r] = floor_div(a, b);
+        auto [s, t] = floor_div(c, d);
+        if (q != s) return order(q, s);
+        if (r == T(0) || t == T(0)) return order(r != T(0), t != T(0));
+        a = d, c = b, b = t, d = r;
+    }
+}
+
+// a / b <=> c / d for b, d > 0, reduced or not, as a * d <=> c * b in a type wide enough for the products
+template<typename T>
+constexpr std::strong_ordering cross_order(T const& a, T const& b, T const& c, T const& d) {
+    using W = typename widened<T>::type;
+    if (b == d) return order(a, c);
+    if constexpr (std::is_void_v<W>) {
+        return euclid_order(a, b, c, d);
+    } else {
+        return order(W(a) * W(d), W(c) * W(b));
+    }
+}
+
+// a finite x as (-1)^negative * fraction * 2^exp with an odd fraction, or a zero fraction
+struct binary_parts {
+    bool negative;
+    bitfield fraction;
+    int exp;
+};
+
+template<std::floating_point FP>
+constexpr binary_parts split(FP x) {
+    FPBits<FP> bits(x);
+    if (!bits.is_finite()) throw std::invalid_argument("rational: not a finite number");
+    bitfield fraction = bits.full_fraction();
+    int exp = bits.partial_log2();
+    if (!fraction) return {false, 0, 0};
+    if (!uint64_t(fraction)) fraction >>= 64, exp += 64;
+    int zeros = std::countr_zero(uint64_t(fraction));
+    return {bits.sign(), fraction >> zeros, exp + zeros};
+}
+
+constexpr size_t width(bitfield x) {
+    return x >> 64 ? 64 + std::bit_width(uint64_t(x >> 64)) : std::bit_width(uint64_t(x));
+}
+
+// whether both the numerator, with its sign, and the denominator 2^-exp fit IntType
+template<typename IntType>
+constexpr bool fits(binary_parts const& x) {
+    constexpr size_t CAPACITY = capacity<IntType>;
+    if (x.negative && unsigned_only<IntType>) return false;
+    if (!CAPACITY) return true;
+    if (x.exp >= 0) return width(x.fraction) + size_t(x.exp) <= CAPACITY;
+    return width(x.fraction) <= CAPACITY && size_t(-x.exp) < CAPACITY;
+}
+
+template<typename IntType>
+constexpr IntType from_bits(bitfield x) {
+    if (!(x >> 64)) return IntType(uint64_t(x));
+    if constexpr (!capacity<IntType> || capacity<IntType> > 64) {
+        return ((IntType(uint64_t(x >> 64)) << 32) << 32) + IntType(uint64_t(x));
+    }
+    throw std::overflow_error("rational: the fraction does not fit");
+}
+
+// holds any finite FP exactly, with the denominator up to 2^(EXPONENT_OFFSET - 1 + FRACTION) of the subnormals
+template<std::floating_point FP>
+using exact_t = wide_int<((FPBits<FP>::EXPONENT_OFFSET + FPBits<FP>::FRACTION + 1) / 64 + 1) * 64, true>;
+
+}
+
+/*
+ * the fraction num / den in the lowest terms with den > 0; the operations
+ * take the operands as reduced, so that the gcds are those of the smaller
+ * numbers by the methods of Knuth and no product overflows before the result does
+ */
 template<typename IntType>
 class Rational {
     IntType num, den;
+
+    struct reduced_t {};
+    constexpr Rational(IntType n, IntType d, reduced_t): num(std::move(n)), den(std::move(d)) {}
+
 public:
     typedef IntType int_type;
     constexpr Rational(): num(0), den(1) {}
     constexpr Rational(IntType n): num(n), den(1) {}
     constexpr Rational(IntType n, IntType d): num(n), den(d) { normalize(); }
 
-    constexpr Rational(Rational const&) = default;
-    constexpr Rational(Rational&&) = default;
+    // n / d as is, for the fractions known to be in the lowest terms with d > 0
+    static constexpr Rational from_reduced(IntType n, IntType d) {
+        return {std::move(n), std::move(d), reduced_t{}};
+    }
+
+    // the exact value of a finite x, whose denominator is a power of 2
+    template<std::floating_point FP>
+    static constexpr Rational from_double(FP x) {
+        rationals::binary_parts parts = rationals::split(x);
+        if (!rationals::fits<IntType>(parts)) throw std::overflow_error("rational: the floating point does not fit");
+        IntType n = rationals::from_bits<IntType>(parts.fraction), d(1);
+        if (parts.exp >= 0) n = n << size_t(parts.exp);
+        else d = d << size_t(-parts.exp);
+        if (parts.negative) n = -n;
+        return {std::move(n), std::move(d), reduced_t{}};
+    }
 
     constexpr void numerator(IntType n) {
-        assgin(n, den);
+        assign(n, den);
     }
 
     constexpr IntType numerator()const {
@@ -30,7 +242,7 @@ public:
     }
 
     constexpr void denominator(IntType d) {
-        assgin(num, d);
+        assign(num, d);
     }
 
     constexpr IntType denominator() const {
@@ -49,64 +261,76 @@ public:
     }
 
     constexpr Rational<IntType> inverse()const {
-        if (den == IntType(0)) throw BadRational();
-        return {den, num};
+        if (num == IntType(0)) throw BadRational();
+        if (num < IntType(0)) return {-den, -num, reduced_t{}};
+        return {den, num, reduced_t{}};
     }
-    
+
     constexpr Rational<IntType> operator+()const {
         return *this;
     }
 
     constexpr Rational<IntType> operator-()const {
-        return {-num, den};
+        return {-num, den, reduced_t{}};
     }
 
-    friend constexpr Rational<IntType> operator+(Rational<IntType> const& x, 
+    // with d1 = gcd(b, d), a / b + c / d = t / (b / d1 * d) where t = a * (d / d1) + c * (b / d1) and gcd(t, d1) is all to cancel
+    friend constexpr Rational<IntType> operator+(Rational<IntType> const& x,
             Rational<IntType> const& y) {
-        return {x.num * lcm(x.den, y.den) / x.den + y.num * lcm(x.den, y.den) / y.den, lcm(x.den, y.den)};
+        using rationals::gcd_of;
+        IntType d1 = gcd_of(x.den, y.den);
+        if (d1 == IntType(1)) return {x.num * y.den + y.num * x.den, x.den * y.den, reduced_t{}};
+        IntType xd = x.den / d1, t = x.num * (y.den / d1) + y.num * xd;
+        if (t == IntType(0)) return {};
+        IntType d2 = gcd_of(t, d1);
+        return {t / d2, xd * (y.den / d2), reduced_t{}};
     }
 
-    friend constexpr Rational<IntType> operator-(Rational<IntType> const& x, 
+    friend constexpr Rational<IntType> operator-(Rational<IntType> const& x,
             Rational<IntType> const& y) {
         return x + -y;
     }
 
-    friend constexpr Rational<IntType> operator*(Rational<IntType> const& x, 
+    // a / b * c / d cancels a with d and c with b first
+    friend constexpr Rational<IntType> operator*(Rational<IntType> const& x,
             Rational<IntType> const& y) {
-        return {x.num * y.num, x.den * y.den};
+        using rationals::gcd_of;
+        if (x.num == IntType(0) || y.num == IntType(0)) return {};
+        IntType d1 = gcd_of(x.num, y.den), d2 = gcd_of(y.num, x.den);
+        return {(x.num / d1) * (y.num / d2), (x.den / d2) * (y.den / d1), reduced_t{}};
     }
 
-    friend constexpr Rational<IntType> operator/(Rational<IntType> const& x, 
+    friend constexpr Rational<IntType> operator/(Rational<IntType> const& x,
             Rational<IntType> const& y) {
         return x * y.inverse();
     }
 
-    constexpr Rational<IntType> operator+=(Rational<IntType> const& y) {
+    constexpr Rational<IntType>& operator+=(Rational<IntType> const& y) {
         return *this = *this + y;
     }
 
-    constexpr Rational<IntType> operator-=(Rational<IntType> const& y) {
+    constexpr Rational<IntType>& operator-=(Rational<IntType> const& y) {
         return *this = *this - y;
     }
 
-    constexpr Rational<IntType> operator*=(Rational<IntType> const& y) {
+    constexpr Rational<IntType>& operator*=(Rational<IntType> const& y) {
         return *this = *this * y;
     }
 
-    constexpr Rational<IntType> operator/=(Rational<IntType> const& y) {
+    constexpr Rational<IntType>& operator/=(Rational<IntType> const& y) {
         return *this = *this / y;
     }
-    
-    friend constexpr bool operator==(Rational<IntType> const& x, 
+
+    friend constexpr bool operator==(Rational<IntType> const& x,
                                      Rational<IntType> const& y) = default;
-    
-    friend constexpr std::strong_ordering operator<=>(Rational<IntType> const& x, 
+
+    friend constexpr std::strong_ordering operator<=>(Rational<IntType> const& x,
                                                       Rational<IntType> const& y) {
-        return x.num * lcm(x.den, y.den) / x.den <=> y.num * lcm(x.den, y.den) / y.den;
+        return rationals::cross_order(x.num, x.den, y.num, y.den);
     }
-    
+
     friend constexpr Rational<IntType> abs(Rational<IntType> const& x) {
-        return {std::abs(x.num), x.den};
+        return {rationals::magnitude(x.num), x.den, reduced_t{}};
     }
 
     constexpr void normalize() {
@@ -117,7 +341,7 @@ public:
             den = IntType(1);
             return;
         }
-        IntType g = gcd(num, den);
+        IntType g = rationals::gcd_of(num, den);
         num /= g;
         den /= g;
         if (den < zero) {
@@ -131,4 +355,305 @@ public:
     }
 };
 
+/*
+ * a fraction num / den with den > 0 that is not reduced after each operation,
+ * but only when the products of the next one could overflow, and then through
+ * the cancellations of Rational; an unbounded IntType goes through them as well
+ * once the denominator would pass twice its width at the last reduction, so
+ * that the numbers grow at most by half of what the gcds would take away
+ */
+template<typename IntType>
+class LazyRational {
+    IntType num, den;
+    // the width of den when last reduced, and whether it still is
+    size_t base = 1;
+    bool lowest = true;
+
+    constexpr static size_t CAPACITY = rationals::capacity<IntType>;
+
+    struct raw_t {};
+    constexpr LazyRational(IntType n, IntType d, size_t base, bool lowest, raw_t):
+        num(std::move(n)), den(std::move(d)), base(base), lowest(lowest) {}
+
+    // whether a denominator of the width is fine for the operands, which holds for the bounded types once the products fit
+    constexpr static bool within(size_t width, LazyRational<IntType> const& x, LazyRational<IntType> const& y) {
+        return CAPACITY || width <= 2 * std::max(x.base, y.base) + 64;
+    }
+
+public:
+    typedef IntType int_type;
+    constexpr LazyRational(): num(0), den(1) {}
+    constexpr LazyRational(IntType n): num(n), den(1) {}
+    constexpr LazyRational(IntType n, IntType d): num(n), den(d), lowest(false) {
+        if (den == IntType(0)) throw BadRational();
+        if (den < IntType(0)) num = -num, den = -den;
+        base = rationals::width(den);
+    }
+    constexpr LazyRational(Rational<IntType> const& x):
+        num(x.numerator()), den(x.denominator()), base(rationals::width(den)) {}
+
+    constexpr Rational<IntType> reduced() const {
+        if (lowest) return Rational<IntType>::from_reduced(num, den);
+        return {num, den};
+    }
+
+    explicit constexpr operator Rational<IntType>() const {
+        return reduced();
+    }
+
+    constexpr void normalize() {
+        *this = reduced();
+    }
+
+    constexpr LazyRational<IntType> operator-()const {
+        return {-num, den, base, lowest, raw_t{}};
+    }
+
+    friend constexpr LazyRational<IntType> operator+(LazyRational<IntType> const& x,
+            LazyRational<IntType> const& y) {
+        using rationals::width;
+        size_t b = std::max(x.base, y.base);
+        if (x.den == y.den) {
+            if (!CAPACITY || std::max(width(x.num), width(y.num)) < CAPACITY) return {x.num + y.num, x.den, b, false, raw_t{}};
+        } else if (size_t w = width(x.den) + width(y.den); within(w, x, y) && (!CAPACITY
+                || (width(x.num) + width(y.den) < CAPACITY && width(y.num) + width(x.den) < CAPACITY && w <= CAPACITY))) {
+            return {x.num * y.den + y.num * x.den, x.den * y.den, b, false, raw_t{}};
+        }
+        return x.reduced() + y.reduced();
+    }
+
+    friend constexpr LazyRational<IntType> operator-(LazyRational<IntType> const& x,
+            LazyRational<IntType> const& y) {
+        return x + -y;
+    }
+
+    friend constexpr LazyRational<IntType> operator*(LazyRational<IntType> const& x,
+            LazyRational<IntType> const& y) {
+        using rationals::width;
+        size_t w = width(x.den) + width(y.den);
+        if (within(w, x, y) && (!CAPACITY || (width(x.num) + width(y.num) <= CAPACITY && w <= CAPACITY)))
+            return {x.num * y.num, x.den * y.den, std::max(x.base, y.base), false, raw_t{}};
+        return x.reduced() * y.reduced();
+    }
+
+    friend constexpr LazyRational<IntType> operator/(LazyRational<IntType> const& x,
+            LazyRational<IntType> const& y) {
+        if (y.num == IntType(0)) throw BadRational();
+        bool negative = y.num < IntType(0);
+        return x * LazyRational<IntType>(negative ? -y.den : y.den, negative ? -y.num : y.num, y.base, y.lowest, raw_t{});
+    }
+
+    constexpr LazyRational<IntType>& operator+=(LazyRational<IntType> const& y) {
+        return *this = *this + y;
+    }
+
+    constexpr LazyRational<IntType>& operator-=(LazyRational<IntType> const& y) {
+        return *this = *this - y;
+    }
+
+    constexpr LazyRational<IntType>& operator*=(LazyRational<IntType> const& y) {
+        return *this = *this * y;
+    }
+
+    constexpr LazyRational<IntType>& operator/=(LazyRational<IntType> const& y) {
+        return *this = *this / y;
+    }
+
+    // compared by the cross products, which need no reduction
+    friend constexpr bool operator==(LazyRational<IntType> const& x,
+                                     LazyRational<IntType> const& y) {
+        return (x <=> y) == 0;
+    }
+
+    friend constexpr std::strong_ordering operator<=>(LazyRational<IntType> const& x,
+                                                      LazyRational<IntType> const& y) {
+        return rationals::cross_order(x.num, x.den, y.num, y.den);
+    }
+
+    friend std::string toTex(LazyRational const& t) {
+        return toTex(t.reduced());
+    }
+};
+
+// the sum of the terms, reduced once at the end, or whenever the products would overflow otherwise
+template<typename IntType>
+constexpr Rational<IntType> sum(std::span<Rational<IntType> const> terms) {
+    LazyRational<IntType> ret;
+    for (auto const& each : terms) ret += each;
+    return ret.reduced();
 }
+
+/*
+ * the partial quotients [a0; a1, a2, ...] of a fraction by the floor, so that
+ * only a0 may be zero or negative, one Euclidean step at a time
+ */
+template<typename IntType>
+class ContinuedFraction {
+    IntType num, den;
+
+public:
+    class iterator {
+        // the complete quotient p / q after a, and whether a is past the last
+        IntType p = IntType(0), q = IntType(0), a = IntType(0);
+        bool done = true;
+
+        constexpr void step() {
+            if (q == IntType(0)) {
+                done = true;
+                return;
+            }
+            auto [quot, rem] = rationals::floor_div(p, q);
+            a = std::move(quot);
+            p = std::exchange(q, std::move(rem));
+        }
+
+    public:
+        using value_type = IntType;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr iterator() = default;
+
+        constexpr iterator(IntType p, IntType q) : p(std::move(p)), q(std::move(q)), done(false) {
+            step();
+        }
+
+        constexpr IntType const& operator*() const {
+            return a;
+        }
+
+        constexpr iterator& operator++() {
+            step();
+            return *this;
+        }
+
+        constexpr void operator++(int) {
+            ++*this;
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const {
+            return done;
+        }
+    };
+
+    constexpr explicit ContinuedFraction(Rational<IntType> const& x) : num(x.numerator()), den(x.denominator()) {}
+
+    constexpr iterator begin() const {
+        return iterator(num, den);
+    }
+
+    constexpr std::default_sentinel_t end() const {
+        return {};
+    }
+};
+
+// the convergents h / k of a fraction by h = a h1 + h2 and k = a k1 + k2, from a0 to the fraction itself, all in the lowest terms
+template<typename IntType>
+class Convergents {
+    ContinuedFraction<IntType> partials;
+
+public:
+    class iterator {
+        typename ContinuedFraction<IntType>::iterator partial;
+        // the last two convergents, from 1 / 0 and 0 / 1
+        IntType h1 = IntType(1), k1 = IntType(0), h2 = IntType(0), k2 = IntType(1);
+
+        constexpr void step() {
+            if (partial == std::default_sentinel) return;
+            IntType const& a = *partial;
+            h2 = std::exchange(h1, a * h1 + h2);
+            k2 = std::exchange(k1, a * k1 + k2);
+        }
+
+    public:
+        using value_type = Rational<IntType>;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr iterator() = default;
+
+        constexpr explicit iterator(typename ContinuedFraction<IntType>::iterator partial) : partial(std::move(partial)) {
+            step();
+        }
+
+        constexpr Rational<IntType> operator*() const {
+            return Rational<IntType>::from_reduced(h1, k1);
+        }
+
+        constexpr iterator& operator++() {
+            ++partial;
+            step();
+            return *this;
+        }
+
+        constexpr void operator++(int) {
+            ++*this;
+        }
+
+        constexpr bool operator==(std::default_sentinel_t) const {
+            return partial == std::default_sentinel;
+        }
+    };
+
+    constexpr explicit Convergents(Rational<IntType> const& x) : partials(x) {}
+
+    constexpr iterator begin() const {
+        return iterator(partials.begin());
+    }
+
+    constexpr std::default_sentinel_t end() const {
+        return {};
+    }
+};
+
+static_assert(std::ranges::input_range<ContinuedFraction<int64_t>> && std::ranges::input_range<Convergents<int64_t>>);
+
+namespace rationals {
+
+/*
+ * the closest fraction to p / q, q > 0, with a denominator up to max_den, in T
+ * as wide as p and q and with IntType as wide as the result: either the last
+ * convergent h1 / k1 within max_den, or the semiconvergent (t h1 + h2) / (t k1 + k2)
+ * of the largest t within it; their distances to p / q are 1 / (k1 (a' k1 + k2))
+ * and (a' - t) / ((a' k1 + k2) (t k1 + k2)) for the complete quotient a', so the
+ * semiconvergent is closer when a' < 2t + k2 / k1, and the ties go to the convergent
+ */
+template<typename IntType, typename T>
+constexpr Rational<IntType> approximate(T p, T q, IntType const& max_den) {
+    IntType h1(1), k1(0), h2(0), k2(1);
+    while (true) {
+        auto [a, r] = floor_div(p, q);
+        if (k1 == IntType(0)) {
+            if (capacity<IntType> && width(a) > capacity<IntType>)
+                throw std::overflow_error("rational: the integral part does not fit");
+        } else if (IntType t = (max_den - k2) / k1; a > convert<T>(t)) {
+            T e = a - convert<T>(t), u = convert<T>(t);
+            if (e < u || (e == u && cross_order(r, q, convert<T>(k2), convert<T>(k1)) < 0))
+                return Rational<IntType>::from_reduced(t * h1 + h2, t * k1 + k2);
+            return Rational<IntType>::from_reduced(h1, k1);
+        }
+        IntType n = convert<IntType>(a);
+        h2 = std::exchange(h1, n * h1 + h2);
+        k2 = std::exchange(k1, n * k1 + k2);
+        if (r == T(0)) return Rational<IntType>::from_reduced(h1, k1);
+        p = std::exchange(q, std::move(r));
+    }
+}
+
+}
+
+// the closest fraction to x with a denominator from 1 to max_den, where x times max_den should fit IntType
+template<typename IntType, typename T>
+constexpr Rational<IntType> best_approximation(Rational<T> const& x, IntType const& max_den) {
+    if (max_den < IntType(1)) throw std::invalid_argument("best approximation: the denominator bound is below 1");
+    return rationals::approximate(x.numerator(), x.denominator(), max_den);
+}
+
+// by the exact value of x, in __int128 when it fits and otherwise in a type for the whole range of FP
+template<std::floating_point FP, typename IntType>
+constexpr Rational<IntType> best_approximation(FP x, IntType const& max_den) {
+    if (rationals::fits<__int128>(rationals::split(x))) return best_approximation(Rational<__int128>::from_double(x), max_den);
+    return best_approximation(Rational<rationals::exact_t<FP>>::from_double(x), max_den);
+}
+
+}
+
+#endif
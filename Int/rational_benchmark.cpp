@@ -0,0 +1,104 @@
+#include "rational.cpp"
+#include "big_int.cpp"
+#include "benchmark.cpp"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+
+using namespace yao_math;
+
+// the best of the rounds after a warm up, in milliseconds
+template<typename F>
+double measure(F f, size_t rounds) {
+    do_not_optimize(f());
+    double best = INFINITY;
+    for (size_t i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        do_not_optimize(f());
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    return best;
+}
+
+void report(std::string const& what, double eager, double lazy, double sum) {
+    std::cout << std::left << std::setw(28) << what << std::right << std::fixed << std::setprecision(3)
+        << std::setw(12) << eager << std::setw(12) << lazy << std::setw(12) << sum
+        << std::setprecision(2) << std::setw(10) << eager / lazy << std::setw(10) << eager / sum << std::defaultfloat << std::endl;
+}
+
+template<typename T>
+std::vector<Rational<T>> harmonic_terms(int n) {
+    std::vector<Rational<T>> ret;
+    for (int i = 1; i <= n; ++i) ret.emplace_back(T(1), T(i));
+    return ret;
+}
+
+// the terms one at a time into an eager or a lazy accumulator, and all at once by sum
+template<typename T>
+void bench_sum(std::string const& what, std::vector<Rational<T>> const& terms, size_t rounds) {
+    double eager = measure([&] {
+        Rational<T> ret;
+        for (auto const& each : terms) ret += each;
+        return ret;
+    }, rounds);
+    double lazy = measure([&] {
+        LazyRational<T> ret;
+        for (auto const& each : terms) ret += each;
+        return ret.reduced();
+    }, rounds);
+    double all = measure([&] {
+        return sum<T>(terms);
+    }, rounds);
+    report(what, eager, lazy, all);
+}
+
+// [a0; a1, ..., an] from the back as a_k + 1 / x
+template<typename R, typename T>
+R continued_fraction(std::vector<T> const& partials) {
+    R x(partials.back());
+    for (size_t i = partials.size() - 1; i--;) x = R(partials[i]) + R(T(1)) / x;
+    return x;
+}
+
+template<typename T>
+void bench_continued_fraction(std::string const& what, std::vector<T> const& partials, size_t rounds) {
+    double eager = measure([&] { return continued_fraction<Rational<T>>(partials); }, rounds);
+    double lazy = measure([&] { return continued_fraction<LazyRational<T>>(partials).reduced(); }, rounds);
+    report(what, eager, lazy, NAN);
+}
+
+int main() {
+    std::cout << std::left << std::setw(28) << "sum" << std::right << std::setw(12) << "eager ms" << std::setw(12) << "lazy ms"
+        << std::setw(12) << "sum ms" << std::setw(10) << "lazy x" << std::setw(10) << "sum x" << std::endl;
+    // the denominators stay below 720720, so the 64-bit sums never overflow
+    std::mt19937_64 g(24);
+    std::vector<Rational<int64_t>> bounded;
+    for (int i = 0; i < 1'000'000; ++i) bounded.emplace_back(int64_t(g() % 201) - 100, int64_t(g() % 16 + 1));
+    bench_sum("int64 10^6 over 1..16", bounded, 5);
+    // H_n has a denominator of about 1.44 n bits
+    bench_sum("sint1024 H_500", harmonic_terms<sint1024>(500), 5);
+    bench_sum("big_int H_1000", harmonic_terms<big_int>(1000), 5);
+    bench_sum("big_int H_10000", harmonic_terms<big_int>(10000), 1);
+    // the alternating sum of 1 / (F_k F_k+1) converging to the golden ratio
+    std::vector<Rational<big_int>> golden;
+    big_int f0 = 1, f1 = 1;
+    for (int k = 0; k < 2000; ++k) {
+        golden.emplace_back(big_int(k % 2 ? -1 : 1), f0 * f1);
+        big_int next = f0 + f1;
+        f0 = f1;
+        f1 = next;
+    }
+    bench_sum("big_int golden 2000 terms", golden, 5);
+    std::cout << std::endl;
+    // the convergents of sqrt(2) = [1; 2, 2, ...] and e = [2; 1, 2, 1, 1, 4, 1, ...], which are reduced anyway
+    std::vector<big_int> sqrt2(2000, big_int(2)), e = {2};
+    sqrt2[0] = 1;
+    for (int k = 1; e.size() < 2000; ++k) e.insert(e.end(), {big_int(1), big_int(2 * k), big_int(1)});
+    bench_continued_fraction("big_int sqrt(2) 2000 terms", sqrt2, 5);
+    bench_continued_fraction("big_int e 2000 terms", e, 5);
+}
@@ -1,74 +1,290 @@
 #include <vector>
 #include <map>
+#include <array>
 #include <cstdint>
 #include <sstream>
 #include <cmath>
+#include <bit>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include "primality.cpp"
+#include "factor.cpp"
+
+#ifndef YAO_MATH_SIEVE_PRIME
+#define YAO_MATH_SIEVE_PRIME
 
 class SievePrimeEngine {
-	std::vector<uintmax_t> primes = init_primes;
-	uintmax_t current = 50;
-	size_t count = 0;
-	/* count	current
-	 * n		50^(2^n)
+	// which sieves its own segments with the same wheel
+	friend class PrimeRange;
+
+	/* the numbers coprime to 30 are packed 8 to a byte, where bit k of byte i
+	 * stands for 30 * i + residues[k], and sieved by segments of SEGMENT_BYTES
+	 * small enough to stay in L1, each prime carrying its next multiple over
+	 * from one segment to the next
 	 */
-	size_t tail = primes.size();
-	bool compute(uintmax_t below, size_t capacity) {
-		// here we assume the uintmax_t has 64 bits
-		uintmax_t limit = count == 3 ? UINTMAX_MAX : current * current;
-		for (uintmax_t i = current; i <= limit; ++i) {
-			if (i >= below || tail > capacity) return false;
-			if (is_prime(i))
-				primes[tail++] = i;
+	constexpr static size_t SEGMENT_BYTES = 32 * 1024;
+	constexpr static std::array<uint8_t, 8> residues = {1, 7, 11, 13, 17, 19, 23, 29};
+	// from each residue to the next, wrapping around
+	constexpr static std::array<uint8_t, 8> gaps = {6, 4, 2, 4, 2, 4, 6, 2};
+
+	/* the multiples p * m of a prime p = 30 * q + residues[r] are visited for
+	 * m coprime to 30 only, from m = p on; when m % 30 = residues[w], steps[r][w]
+	 * gives the bit of p * m and the carry into the byte from m to m + gaps[w]
+	 */
+	struct Step {
+		uint8_t mask;
+		uint8_t carry;
+	};
+	constexpr static std::array<std::array<Step, 8>, 8> steps = [] {
+		std::array<std::array<Step, 8>, 8> ret{};
+		for (size_t r = 0; r < 8; ++r) for (size_t w = 0; w < 8; ++w) {
+			unsigned product = residues[r] * residues[w] % 30, bit = 0;
+			while (residues[bit] != product) ++bit;
+			ret[r][w].mask = uint8_t(1u << bit);
+			ret[r][w].carry = uint8_t((product + residues[r] * gaps[w]) / 30);
+		}
+		return ret;
+	}();
+
+	struct SievingPrime {
+		uint64_t next;		// the byte of the next multiple
+		uint32_t quotient;	// p / 30
+		uint8_t residue;	// r
+		uint8_t wheel;		// w
+	};
+
+	std::vector<uintmax_t> primes = init_primes;
+	std::vector<SievingPrime> sieving;
+	std::vector<uint8_t> segment;
+	uintmax_t sieved = 30;	// all the primes below are known
+	unsigned threads;
+
+	// the sieving prime p whose multiples go on from the byte low
+	static SievingPrime sieving_prime(uintmax_t p, uint64_t low) {
+		uint8_t r = uint8_t(std::find(residues.begin(), residues.end(), p % 30) - residues.begin());
+		uintmax_t m = std::max<uintmax_t>(p, (30 * low + p - 1) / p);
+		uint8_t w = 0;
+		while (w < 8 && residues[w] < m % 30) ++w;
+		// 30 * (m / 30) + 31 for the residue 1 of the next round
+		if (w == 8) m += 31 - m % 30, w = 0;
+		else m += residues[w] - m % 30;
+		return {p * m / 30, uint32_t(p / 30), r, w};
+	}
+
+	// crosses off the multiples in the bytes [low, low + size)
+	static void cross_off(uint8_t* bytes, uint64_t low, size_t size, std::vector<SievingPrime>& sieving) {
+		uint64_t high = low + size;
+		for (SievingPrime& s : sieving) {
+			if (s.next >= high) continue;
+			auto const& step = steps[s.residue];
+			size_t i = s.next - low, w = s.wheel;
+			do {
+				bytes[i] &= uint8_t(~step[w].mask);
+				i += s.quotient * gaps[w] + step[w].carry;
+				w = (w + 1) & 7;
+			} while (i < size);
+			s.next = low + i;
+			s.wheel = uint8_t(w);
 		}
-		if (count < 3) {
-			++count;
-			current *= current;
+	}
+
+	// appends the primes in the bytes [low, low + size) above last
+	static void collect(std::vector<uintmax_t>& out, uint8_t const* bytes, uint64_t low, size_t size, uintmax_t last) {
+		for (size_t i = 0; i < size; ++i) {
+			for (unsigned bits = bytes[i]; bits; bits &= bits - 1) {
+				uintmax_t p = 30 * (low + i) + residues[std::countr_zero(bits)];
+				if (p > last) out.push_back(p);
+			}
 		}
-		return true;
 	}
+
+	// sieves the bytes in [low, high) and collects their primes
+	void sieve(uint64_t low, uint64_t high) {
+		size_t size = high - low;
+		segment.assign(size, 0xFF);
+		// the primes from 7 on take part once their square is reached
+		for (size_t i = sieving.size() + 3; i < primes.size() && primes[i] * primes[i] < 30 * high; ++i)
+			sieving.push_back(sieving_prime(primes[i], low));
+		cross_off(segment.data(), low, size, sieving);
+		// the initial primes overlap the first segment
+		collect(primes, segment.data(), low, size, primes.back());
+	}
+
+	// sieves the next segment, which stops at below and at the square of the sieved range
+	void extend(uintmax_t below) {
+		uint64_t low = sieved / 30;
+		uint64_t square = sieved >> 32 ? UINT64_MAX : sieved * sieved / 30;
+		uint64_t high = std::max(std::min<uint64_t>({low + SEGMENT_BYTES, square, below / 30 + 1}), low + 1);
+		sieve(low, high);
+		sieved = 30 * high;
+	}
+
+	/* the chunks of CHUNK_BYTES go to the threads one at a time, each thread
+	 * sieving its chunk by segments with its own copy of the sieving primes
+	 * started at the chunk, so nothing is shared but the index of the next chunk
+	 */
+	constexpr static size_t CHUNK_SEGMENTS = 8;
+	constexpr static size_t CHUNK_BYTES = CHUNK_SEGMENTS * SEGMENT_BYTES;
+
+	// the sieving primes must be known up to the square root of 30 * high
+	template<typename F>
+	void sieve_chunks(uint64_t low, uint64_t high, F&& each) const {
+		size_t chunks = (high - low + CHUNK_BYTES - 1) / CHUNK_BYTES;
+		std::atomic<size_t> next = 0;
+		auto work = [&] {
+			std::vector<uint8_t> bytes(SEGMENT_BYTES);
+			std::vector<SievingPrime> local;
+			for (size_t chunk; (chunk = next++) < chunks;) {
+				uint64_t begin = low + chunk * CHUNK_BYTES, end = std::min<uint64_t>(begin + CHUNK_BYTES, high);
+				local.clear();
+				for (size_t i = 3; i < primes.size() && primes[i] * primes[i] < 30 * end; ++i)
+					local.push_back(sieving_prime(primes[i], begin));
+				for (uint64_t from = begin; from < end; from += SEGMENT_BYTES) {
+					size_t size = std::min<uint64_t>(SEGMENT_BYTES, end - from);
+					std::fill_n(bytes.begin(), size, 0xFF);
+					cross_off(bytes.data(), from, size, local);
+					each(chunk, bytes.data(), from, size);
+				}
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < std::min<size_t>(threads, chunks); ++t) pool.emplace_back(work);
+		work();
+		for (auto& thread : pool) thread.join();
+	}
+
+	// knows the sieving primes for the numbers below, i.e. up to its square root
+	void compute_sieving(uintmax_t below) {
+		uintmax_t root = std::min<uintmax_t>(std::sqrt(double(below)), UINT32_MAX);
+		while (root < UINT32_MAX && (root + 1) * (root + 1) <= below) ++root;
+		while (root * root > below) --root;
+		// past the initial primes, which the first segment overlaps
+		computeBelow(std::max<uintmax_t>(root + 1, init_primes.end()[-1]));
+	}
+
 public:
 	constexpr static std::initializer_list<uintmax_t> 
 		init_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+
+	// 0 threads for as many as the hardware runs
+	explicit SievePrimeEngine(unsigned threads = 1) {
+		set_threads(threads);
+	}
+
+	void set_threads(unsigned count) {
+		threads = count ? count : std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	unsigned get_threads() const {
+		return threads;
+	}
 	
-	bool is_prime(uintmax_t n) {
-		switch (n) {
-			case 0: case 1: return false;
-			case 2: case 3: case 5: case 7: return true;
-			default: if ((n & 1) == 0) return false; // shortcut for even numbers
-		}
-		for (uintmax_t i = 1 /*skipping 2*/ ; primes[i] * primes[i] <= n; ++i)
-			if (n % primes[i] == 0)
-				return false;
-		return true;
+	// looks the sieved numbers up, and tests the others by Miller-Rabin
+	bool is_prime(uintmax_t n) const {
+		if (n < sieved) return std::binary_search(primes.begin(), primes.end(), n);
+		return yao_math::is_prime(n);
 	}
 	
+	// makes sure all the primes below are known, sieving only what is new
 	void computeBelow(uintmax_t below) {
-		if (below <= primes.back()) return;
+		if (below <= sieved) return;
 		double ln = std::log(below);
-		size_t estimate = below / (ln - 1.1);
-		primes.resize(std::max(estimate, primes.size()));
-		while (compute(below, -1));
-		primes.resize(tail);
+		primes.reserve(std::max<size_t>(below / (ln - 1.1), primes.size()));
+		if (threads == 1 || below / 30 - sieved / 30 < 2 * CHUNK_BYTES) {
+			while (sieved < below) extend(below);
+			return;
+		}
+		compute_sieving(below);
+		/* the primes of each chunk are collected apart and appended in order,
+		 * a round of a few chunks per thread at a time to bound the memory
+		 */
+		uint64_t high = below / 30 + 1;
+		std::vector<std::vector<uintmax_t>> found(4 * threads);
+		for (uint64_t low = sieved / 30; low < high;) {
+			uint64_t end = std::min<uint64_t>(low + found.size() * CHUNK_BYTES, high);
+			sieve_chunks(low, end, [&](size_t chunk, uint8_t const* bytes, uint64_t from, size_t size) {
+				collect(found[chunk], bytes, from, size, 0);
+			});
+			for (auto& each : found) {
+				primes.insert(primes.end(), each.begin(), each.end());
+				each.clear();
+			}
+			low = end;
+		}
+		sieved = 30 * high;
+		// the chunks went by their own copies, so the next segment seeds the sieving primes afresh at its low
+		sieving.clear();
+	}
+
+	// counts the primes below without keeping them, but those up to its square root
+	size_t count_below(uintmax_t below) {
+		if (below <= sieved)
+			return std::lower_bound(primes.begin(), primes.end(), below) - primes.begin();
+		compute_sieving(below);
+		if (below <= sieved)
+			return std::lower_bound(primes.begin(), primes.end(), below) - primes.begin();
+		uint64_t high = below / 30 + (below % 30 != 0);
+		std::vector<size_t> counts((high - sieved / 30 + CHUNK_BYTES - 1) / CHUNK_BYTES);
+		sieve_chunks(sieved / 30, high, [&](size_t chunk, uint8_t const* bytes, uint64_t from, size_t size) {
+			size_t count = 0;
+			for (size_t i = 0; i < size; ++i) count += std::popcount(bytes[i]);
+			// the last byte may go over
+			if (from + size == high) {
+				for (unsigned bits = bytes[size - 1]; bits; bits &= bits - 1)
+					count -= 30 * (high - 1) + residues[std::countr_zero(bits)] >= below;
+			}
+			counts[chunk] += count;
+		});
+		size_t ret = primes.size();
+		for (size_t count : counts) ret += count;
+		return ret;
+	}
+	
+	/* the primes below as a bitmap of the numbers coprime to 30, byte i of which
+	 * is at the bits 8 * (i % 8) of word i / 8, so 2, 3 and 5 are left out;
+	 * the chunks are sieved on the threads straight into the words
+	 */
+	std::vector<uint64_t> bitmap(uintmax_t below) {
+		compute_sieving(below);
+		uint64_t high = below / 30 + (below % 30 != 0);
+		std::vector<uint64_t> ret((high + 7) / 8);
+		sieve_chunks(0, high, [&](size_t, uint8_t const* bytes, uint64_t from, size_t size) {
+			// the segments start at a multiple of 8 bytes, so no two threads share a word
+			for (size_t i = 0; i < size; ++i)
+				ret[(from + i) / 8] |= uint64_t(bytes[i]) << (8 * ((from + i) % 8));
+		});
+		if (high) {
+			// 1 is not a prime, and the last byte may go over
+			ret[0] &= ~uint64_t(1);
+			for (unsigned k = 0; k < 8; ++k)
+				if (bitmap_number(high - 1, k) >= below) ret[(high - 1) / 8] &= ~(uint64_t(1) << (8 * ((high - 1) % 8) + k));
+		}
+		return ret;
+	}
+
+	// the number of bit k of byte i in the bitmap
+	constexpr static uintmax_t bitmap_number(uint64_t i, unsigned k) {
+		return 30 * i + residues[k];
 	}
 	
+	// makes sure at least capacity primes are known
 	void computeCapacity(size_t capacity) {
 		if (capacity <= primes.size()) return;
-		primes.resize(std::max(capacity, primes.size()));
-		while (compute(-1, capacity));
+		primes.reserve(capacity);
+		while (primes.size() < capacity) extend(UINTMAX_MAX);
+	}
+	
+	std::vector<uintmax_t> const& get_primes() const {
+		return primes;
 	}
 	
-	std::map<uintmax_t, size_t> split(uintmax_t value) {
+	// the complete factorization, whether its primes are computed or not
+	std::map<uintmax_t, size_t> split(uintmax_t value) const {
 		if (value < 2)
 			throw std::invalid_argument(std::to_string(value) + " is too small to split");
-		std::map<uintmax_t, size_t> ret;
-		for (uintmax_t each : primes) {
-			while (value % each == 0) {
-				++ret[each];
-				value /= each;
-			}
-			if (value == 1) break;
-		}
-		return ret;
+		return yao_math::factor_map(value);
 	}
 	
 	std::ostream& print_split(std::ostream& out, uintmax_t value) {
@@ -91,3 +307,5 @@ public:
 	}
 	
 };
+
+#endif
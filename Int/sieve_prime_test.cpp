@@ -8,4 +8,23 @@ int main() {
     engine.computeBelow(n);
     std::cout << std::boolalpha << engine.is_prime(n) << std::endl;
     std::cout << engine.get_split(n) << std::endl;
+    // extending over many segments keeps the count of pi(10^7)
+    engine.computeBelow(10000000);
+    auto const& primes = engine.get_primes();
+    size_t count = std::lower_bound(primes.begin(), primes.end(), 10000000) - primes.begin();
+    std::cout << "pi(10^7) = " << count << std::endl;
+    // the threads take the segments out of order but merge them back in order
+    SievePrimeEngine parallel(4);
+    parallel.computeBelow(10000000);
+    bool same = std::equal(primes.begin(), primes.begin() + count, parallel.get_primes().begin());
+    size_t pi8 = SievePrimeEngine(4).count_below(100000000);
+    std::cout << "pi(10^8) = " << pi8 << std::endl;
+    // a single-threaded step after the threaded ones goes on from where they stopped
+    parallel.computeBelow(100000000);
+    parallel.computeBelow(103000000);
+    parallel.computeCapacity(parallel.get_primes().size() + 1000);
+    engine.computeCapacity(parallel.get_primes().size());
+    bool resumed = std::equal(parallel.get_primes().begin(), parallel.get_primes().end(), engine.get_primes().begin());
+    std::cout << "resumed after the threads: " << resumed << std::endl;
+    return count != 664579 || !same || pi8 != 5761455 || !resumed;
 }
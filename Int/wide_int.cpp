@@ -6,49 +6,50 @@
 #include <random>
 #include <bit>
 #include <array>
+#include <span>
 
 #include "../yao_math.h"
 #include "int_base.cpp"
 #include "fpbits.cpp"
+#include "limb.cpp"
+#include "radix.cpp"
+
+#ifndef YAO_MATH_WIDE_INT
+#define YAO_MATH_WIDE_INT
 
 namespace yao_math {
     using byte = unsigned char;
 
-    constexpr size_t log2byte(byte b) {
-        if (b == 0) throw std::invalid_argument("log2byte(0) is invalid");
-        else return
-            " 011222233333333444444444444444455555555555555555555555555555555"
-            "6666666666666666666666666666666666666666666666666666666666666666"
-            "7777777777777777777777777777777777777777777777777777777777777777"
-            "7777777777777777777777777777777777777777777777777777777777777777"
-            [b] - '0';
-    }
-
-    constexpr void memset(byte *dst, byte val, size_t size) noexcept {
-        if constexpr (std::is_constant_evaluated()) {
+    template<typename T>
+    constexpr void memset(T *dst, T val, size_t size) noexcept {
+        if (std::is_constant_evaluated()) {
             for (size_t i = 0; i < size; ++i) dst[i] = val;
-        } else {
+        } else if constexpr (sizeof(T) == 1) {
             std::memset(dst, val, size);
+        } else {
+            std::fill_n(dst, size, val);
         }
     }
 
-    constexpr void memcpy(byte *dst, const byte *src, size_t size) noexcept {
-        if constexpr (std::is_constant_evaluated()) {
+    template<typename T>
+    constexpr void memcpy(T *dst, const T *src, size_t size) noexcept {
+        if (std::is_constant_evaluated()) {
             for (size_t i = 0; i < size; ++i) dst[i] = src[i];
         } else {
-            std::memcpy(dst, src, size);
+            std::memcpy(dst, src, size * sizeof(T));
         }
     }
 
-    constexpr void memmove(byte *dst, const byte *src, size_t size) noexcept {
-        if constexpr (std::is_constant_evaluated()) {
+    template<typename T>
+    constexpr void memmove(T *dst, const T *src, size_t size) noexcept {
+        if (std::is_constant_evaluated()) {
             if (src > dst) {
                 for (size_t i = 0; i < size; ++i) dst[i] = src[i];
             } else {
                 for (size_t i = size - 1; /* i >= 0 */ ~i; --i) dst[i] = src[i];
             }
         } else {
-            std::memmove(dst, src, size);
+            std::memmove(dst, src, size * sizeof(T));
         }
     }
 
@@ -75,16 +76,24 @@ struct wide_int {
     constexpr static size_t BITS = N;
     constexpr static size_t BYTES = BITS >> 3;
 
-    byte bytes[BYTES];
+    // the number is stored as little-endian limbs of the widest
+    // unsigned type dividing N, which is 64-bit for all the aliases
+    using limb_type = limb::limb_for<N>;
+    constexpr static size_t LIMB_BITS = limb::bits<limb_type>;
+    constexpr static size_t LIMBS = BITS / LIMB_BITS;
+    constexpr static limb_type LIMB_MAX = ~limb_type(0);
+
+    limb_type limbs[LIMBS];
 
     constexpr wide_int() noexcept {
-        memset(bytes, 0, BYTES);
+        memset(limbs, limb_type(0), LIMBS);
     }
 
     template<std::unsigned_integral Unsigned>
     constexpr wide_int(Unsigned u) noexcept : wide_int() {
-        auto buf = std::bit_cast<std::array<byte, std::min(BYTES, sizeof u)>>(u);
-        memcpy(bytes, buf.data(), buf.size());
+        for (size_t i = 0; i < LIMBS && i * LIMB_BITS < (sizeof u << 3); ++i) {
+            limbs[i] = limb_type(u >> (i * LIMB_BITS));
+        }
     }
 
     template<std::signed_integral Signed>
@@ -92,37 +101,62 @@ struct wide_int {
         wide_int(static_cast<std::make_unsigned_t<Signed>>(s)) {
         size_t size = sizeof s;
         if (s < 0 && BYTES > size) {
-            memset(bytes + size, 0xFF, BYTES - size);
+            fill_from(size << 3, LIMB_MAX);
         }
     }
 
     template<size_t M, bool R>
     constexpr wide_int(wide_int<M, R> const& rhs) noexcept : wide_int() {
-        memcpy(bytes, rhs.bytes, std::min(BYTES, rhs.BYTES));
+        using rhs_limb = typename wide_int<M, R>::limb_type;
+        if constexpr (std::is_same_v<limb_type, rhs_limb>) {
+            memcpy(limbs, rhs.limbs, std::min(LIMBS, rhs.LIMBS));
+        } else {
+            for (size_t i = 0; i < std::min(BYTES, rhs.BYTES); ++i) {
+                set_byte(i, rhs.get_byte(i));
+            }
+        }
         if (rhs.is_negative() && BYTES > rhs.BYTES) {
-            memset(bytes + rhs.BYTES, 0xFF, BYTES - rhs.BYTES);
+            fill_from(rhs.BITS, LIMB_MAX);
         }
     }
 
     template<std::unsigned_integral Unsigned>
     constexpr wide_int& operator=(Unsigned u) noexcept {
-        return *new (this) wide_int(u);
+        return *this = wide_int(u);
     }
 
     template<std::signed_integral Signed>
     constexpr wide_int& operator=(Signed s) noexcept {
-        return *new (this) wide_int(s);
+        return *this = wide_int(s);
     }
 
     template<size_t M, bool R>
     constexpr wide_int& operator=(wide_int<M, R> const& rhs) noexcept {
-        if (this != &rhs) *new (this) wide_int(rhs);
-        return *this;
+        return *this = wide_int(rhs);
+    }
+
+    // sets all the bits from the n-th bit upwards, which must be zero, by fill
+    constexpr void fill_from(size_t n, limb_type fill) noexcept {
+        size_t i = n / LIMB_BITS;
+        if (i < LIMBS) {
+            limbs[i] |= fill << (n % LIMB_BITS);
+            memset(limbs + i + 1, fill, LIMBS - i - 1);
+        }
+    }
+
+    constexpr byte get_byte(size_t i) const noexcept {
+        return byte(limbs[i / sizeof(limb_type)] >> ((i % sizeof(limb_type)) << 3));
+    }
+
+    constexpr void set_byte(size_t i, byte b) noexcept {
+        size_t shift = (i % sizeof(limb_type)) << 3;
+        limb_type& l = limbs[i / sizeof(limb_type)];
+        l = (l & ~(limb_type(0xFF) << shift)) | (limb_type(b) << shift);
     }
 
     constexpr wide_int& complement() noexcept {
-        for (size_t i = 0; i < BYTES; ++i) {
-            bytes[i] = ~bytes[i];
+        for (size_t i = 0; i < LIMBS; ++i) {
+            limbs[i] = ~limbs[i];
         }
         return *this;
     }
@@ -133,7 +167,8 @@ struct wide_int {
     }
 
     constexpr wide_int& negative() noexcept {
-        return complement().operator++();
+        limb::neg_n(limbs, limbs, LIMBS);
+        return *this;
     }
 
     constexpr wide_int operator+() const noexcept {
@@ -150,22 +185,18 @@ struct wide_int {
     }
 
     constexpr wide_int& operator+=(wide_int const& rhs) noexcept {
-        if (this == &rhs) return operator<<=(1);
-        unsigned carry = 0;
-        for (size_t i = 0; i < BYTES; ++i) {
-            carry += bytes[i] + rhs.bytes[i];
-            bytes[i] = carry & 0xFF;
-            carry >>= 8;
-        }
+        limb::add_n(limbs, limbs, rhs.limbs, LIMBS);
         return *this;
     }
 
     constexpr wide_int& operator-=(wide_int const& rhs) noexcept {
-        return operator+=(-rhs);
+        limb::sub_n(limbs, limbs, rhs.limbs, LIMBS);
+        return *this;
     }
 
     constexpr wide_int& operator++() noexcept {
-        return operator+=(1);
+        limb::add_1(limbs, limbs, LIMBS, limb_type(1));
+        return *this;
     }
 
     constexpr wide_int operator++(int) noexcept {
@@ -175,7 +206,8 @@ struct wide_int {
     }
 
     constexpr wide_int& operator--() noexcept {
-        return operator-=(1);
+        limb::sub_1(limbs, limbs, LIMBS, limb_type(1));
+        return *this;
     }
 
     constexpr wide_int operator--(int) noexcept {
@@ -189,7 +221,7 @@ struct wide_int {
     }
 
     constexpr wide_int& operator /=(wide_int const& rhs) {
-        return *this = div(rhs).qout;
+        return *this = div(rhs).quot;
     }
     
     constexpr wide_int& operator %=(wide_int const& rhs) {
@@ -198,8 +230,8 @@ struct wide_int {
 
 #define YAO_MATH_WIDE_INT_BITWISE_OP(op) \
 constexpr wide_int& operator op##=(wide_int const& rhs) noexcept { \
-    for (size_t i = 0; i < BYTES; ++i) \
-        bytes[i] op##= rhs.bytes[i]; \
+    for (size_t i = 0; i < LIMBS; ++i) \
+        limbs[i] op##= rhs.limbs[i]; \
     return *this; \
 }
 
@@ -210,54 +242,21 @@ YAO_MATH_WIDE_INT_BITWISE_OP(^)
 #undef YAO_MATH_WIDE_INT_BITWISE_OP
 
     constexpr wide_int& shiftLeftBytes(size_t rhs) noexcept {
-        if (rhs) {
-            rhs = std::min(rhs, BYTES);
-            memmove(bytes + rhs, bytes, BYTES - rhs);
-            memset(bytes, 0, rhs);
-        }
-        return *this;
+        return operator<<=(rhs << 3);
     }
 
     constexpr wide_int& operator<<=(size_t rhs) noexcept {
-        size_t rbyte = rhs >> 3;
-        size_t rbit = rhs & 7;
-        shiftLeftBytes(rbyte);
-        if (!rbit || !*this) return *this;
-        for (size_t i = BYTES - 1; i >= rbyte && /* i >= 0 */ ~i; --i) {
-            byte rem = bytes[i] >> (8 - rbit);
-            bytes[i] <<= rbit;
-            if (i + 1 < BYTES) {
-                bytes[i + 1] |= rem;
-            }
-        }
+        limb::shift_left(limbs, limbs, LIMBS, rhs);
         return *this;
     }
 
     constexpr wide_int& shiftRightBytes(size_t rhs) noexcept {
-        if (rhs) {
-            rhs = std::min(rhs, BYTES);
-            memmove(bytes, bytes + rhs, BYTES - rhs);
-            memset(bytes + BYTES - rhs, is_negative() ? 0xFF : 0, rhs);
-        }
-        return *this;
+        return operator>>=(rhs << 3);
     }
 
+    // arithmetic for signed numbers
     constexpr wide_int& operator>>=(size_t rhs) noexcept {
-        size_t rbyte = rhs >> 3;
-        size_t rbit = rhs & 7;
-        shiftRightBytes(rbyte);
-        if (!rbit || !*this) return *this;
-        const byte mask = (1 << rbit) - 1;
-        for (size_t i = 0; i < BYTES - rbyte; ++i) {
-            byte rem = bytes[i] & mask;
-            bytes[i] >>= rbit;
-            if (i > 0) {
-                bytes[i - 1] |= rem << (8 - rbit);
-            }
-        }
-        if(is_negative()) {
-            bytes[BYTES - rbyte - 1] |= mask << (8 - rbit);
-        }
+        limb::shift_right(limbs, limbs, LIMBS, rhs, is_negative() ? LIMB_MAX : limb_type(0));
         return *this;
     }
 
@@ -288,17 +287,31 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
     static constexpr wide_int exp2(size_t n) {
         wide_int ret;
         if (n < ret.BITS) {
-            ret.bytes[n >> 3] = 1 << (n & 7);
+            ret.limbs[n / LIMB_BITS] = limb_type(1) << (n % LIMB_BITS);
         }
         return ret;
     }
     
+    // the bit scans see the two's complement bits, as std:: does on the unsigned type
+
+    constexpr size_t countl_zero() const noexcept {
+        return limb::countl_zero(limbs, LIMBS);
+    }
+
+    constexpr size_t countr_zero() const noexcept {
+        return limb::countr_zero(limbs, LIMBS);
+    }
+
+    constexpr size_t popcount() const noexcept {
+        return limb::popcount(limbs, LIMBS);
+    }
+
+    constexpr size_t bit_width() const noexcept {
+        return limb::bit_width(limbs, LIMBS);
+    }
+
     constexpr size_t log2() const {
-        for (size_t i = BYTES - 1; /* i >= 0 */ ~i; --i) {
-            if (bytes[i]) {
-                return (i << 3) + log2byte(bytes[i]);
-            }
-        }
+        if (size_t width = bit_width()) return width - 1;
         throw std::invalid_argument("0.log2() is invalid");
     }
 
@@ -306,86 +319,88 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
         wide_int quot, rem;
     };
 
-    constexpr div_t div(wide_int rhs) const {
+    // truncates towards zero, the remainder takes the sign of the dividend
+    constexpr div_t div(wide_int const& rhs) const {
         if (!rhs) throw std::invalid_argument("divided by 0");
-        if (!*this) return {0, 0};
-        if (SIGNED) {
-            if (is_negative()) {
-                if (rhs.is_negative()) {
-                    div_t d = operator-().div(-rhs);
-                    d.rem.negative();
-                    return d;
-                } else {
-                    div_t d = operator-().div(rhs);
-                    d.quot.negative();
-                    d.rem.negative();
-                    return d;
-                }
-            } else if (rhs.is_negative()) {
-                div_t d = div(-rhs);
-                d.quot.negative();
-                return d;
-            }
-        }
-        size_t rbits = rhs.log2();
-        wide_int rem = *this;
-        wide_int qout;
-        int cmp;
-        while ((cmp = rem.compare(rhs)) > 0 /*rem > rhs*/) {
-            size_t bits = rem.log2();
-            size_t shift = bits - rbits;
-            wide_int q = rhs << shift;
-            if (q > rem && shift) {
-                --shift;
-                q >>= 1;
-            }
-            rem -= q;
-            qout += exp2(shift);
-        }
-        if (cmp == 0 /*rem == rhs*/) {
-            ++qout;
-            rem = 0;
+        bool qneg = is_negative() != rhs.is_negative();
+        bool rneg = is_negative();
+        // the magnitudes are taken as unsigned, so even the minimum is fine
+        wide_int a = abs(), d = rhs.abs();
+        size_t an = a.significant_limbs(), dn = d.significant_limbs();
+        div_t ret;
+        if (an < dn) {
+            ret.rem = a;
+        } else if (d.popcount() == 1) {
+            // a power of two only takes a shift and a mask
+            limb::shift_right(ret.quot.limbs, a.limbs, LIMBS, d.countr_zero());
+            ret.rem = a & (d - wide_int(1));
+        } else {
+            limb_type scratch[limb::divrem_scratch(LIMBS, LIMBS)];
+            limb::divrem(ret.quot.limbs, ret.rem.limbs, a.limbs, an, d.limbs, dn, scratch);
         }
-        return {qout, rem};
+        if (qneg) ret.quot.negative();
+        if (rneg) ret.rem.negative();
+        return ret;
+    }
+
+    // the number of limbs up to the highest nonzero one
+    constexpr size_t significant_limbs() const noexcept {
+        size_t n = LIMBS;
+        while (n && !limbs[n - 1]) --n;
+        return n;
     }
 
     explicit constexpr operator bool() const noexcept {
-        for (size_t i = 0; i < BYTES; ++i) {
-            if (bytes[i]) return true;
+        for (size_t i = 0; i < LIMBS; ++i) {
+            if (limbs[i]) return true;
         }
         return false;
     }
     
     constexpr bool highest_bit() const noexcept {
-        return bytes[BYTES - 1] >> 7;
+        return limbs[LIMBS - 1] >> (LIMB_BITS - 1);
     }
 
     constexpr byte to_byte() const noexcept {
-        return bytes[0];
+        return byte(limbs[0]);
     }
 
     static constexpr wide_int from_byte(byte b) noexcept {
         wide_int ret;
-        ret.bytes[0] = b;
+        ret.limbs[0] = b;
         return ret;
     }
 
     template<std::integral Integral>
     constexpr Integral to_integral() const noexcept {
         static_assert(!std::is_same_v<Integral, bool>, "use operator bool() instead");
-        std::array<byte, std::min(BYTES, sizeof(Integral))> buf;
-        memcpy(buf.data(), bytes, buf.size());
-        return std::bit_cast<Integral>(buf);
+        using U = std::make_unsigned_t<Integral>;
+        U ret = 0;
+        for (size_t i = 0; i < LIMBS && i * LIMB_BITS < (sizeof(U) << 3); ++i) {
+            ret |= U(limbs[i]) << (i * LIMB_BITS);
+        }
+        return static_cast<Integral>(ret);
     }
 
+    // truncates toward zero and wraps around like the integral conversions, NaN and infinities give zero
     template<std::floating_point FP>
     static constexpr wide_int from_float(FP fp) noexcept {
         FPBits<FP> fpbits(fp);
-        wide_int ret = fpbits.full_fraction();
-        if (ret) {
-            ret.shift(fpbits.partial_log2());
-            if (fpbits.sign) ret.negative();
-        }
+        wide_int ret;
+        if (!fpbits.is_finite()) return ret;
+        bitfield fraction = fpbits.full_fraction();
+        int exp = fpbits.partial_log2();
+        if (exp < 0) {
+            if (-exp >= 128) return ret;
+            fraction >>= -exp;
+            exp = 0;
+        }
+        // the fraction is written straight into the limbs it covers
+        for (size_t i = size_t(exp) / LIMB_BITS, off = size_t(exp) % LIMB_BITS; i < LIMBS && fraction; ++i, off = 0) {
+            ret.limbs[i] = limb_type(fraction << off);
+            fraction >>= LIMB_BITS - off;
+        }
+        if (fpbits.sign()) ret.negative();
         return ret;
     }
 
@@ -397,59 +412,72 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
         return operator+();
     }
 
-    std::string to_string(int base = 10, bool uppercase = false) const {
+    constexpr std::string to_string(int base = 10, bool uppercase = false) const {
         int_base::assertValid(base);
-        std::string buf;
-        div_t d = {abs(), 0};
-        do {
-            d = d.quot.div(base);
-            buf += int_base::to_char_raw(d.rem.to_byte(), base, uppercase);
-        } while (d.quot);
-        if (is_negative()) buf += '-';
-        return {buf.rbegin(), buf.rend()};
+        // the magnitude is taken unsigned so that the minimum keeps its value
+        wide_int<BITS, false> mag = abs();
+        std::string buf(radix::max_digits(BITS, base) + 1, '\0');
+        char* last = buf.data() + buf.size();
+        char* first = radix::to_chars(last, mag.limbs, LIMBS, base, uppercase);
+        if (is_negative()) *--first = '-';
+        return {first, last};
     }
 
     friend std::string toTex(wide_int w) {
         return w.to_string();
     }
 
+    // rounds to nearest, ties to even
     template<std::floating_point FP>
     constexpr FP to_float() const noexcept {
-        FPBits<FP> fpbits;
-        int exp = log2();
-        fpbits.exp2(exp);
-        fpbits.fraction = operator+().shift(-exp + fpbits.FRACTION).template to_integral<bitfield>();
-        fpbits.sign = is_negative();
-        return fpbits;
-    }
-
+        // rounding to nearest is symmetric, and only the negative numbers pay for a copy
+        if (is_negative()) return -abs().to_unsigned().template to_float<FP>();
+        size_t width = bit_width();
+        if (!width) return FP(0);
+        // the 128 bits from the leading one down are read from the top limbs, the rest only decides the rounding
+        size_t low = width > 128 ? width - 128 : 0;
+        size_t top = low / LIMB_BITS, off = low % LIMB_BITS;
+        bitfield window = 0;
+        for (size_t i = top, at = 0; i < LIMBS && at < 128 + off; ++i, at += LIMB_BITS) {
+            window |= at >= off ? bitfield(limbs[i]) << (at - off) : bitfield(limbs[i]) >> (off - at);
+        }
+        window <<= 128 - (width - low);
+        bool sticky = off && limb_type(limbs[top] << (LIMB_BITS - off));
+        for (size_t i = 0; i < top && !sticky; ++i) sticky = limbs[i];
+        return FPBits<FP>::compose(false, window, int(width) - 1, sticky);
+    }
+
+    // uniformly random in [0, upper]
     template<typename G>
-    static wide_int random(G& g, wide_int upper) {
-        int cmp = upper.compare(0);
-        if (cmp < 0) throw std::invalid_argument("negative upper");
-        if (cmp == 0) return 0;
+    static constexpr wide_int random(G& g, wide_int const& upper) {
+        if (upper.is_negative()) throw std::invalid_argument("negative upper");
         wide_int ret;
-        size_t bits = upper.log2();
-        size_t bytes = bits >> 3;
-        size_t rbits = (bits & 7) + 1;
-        size_t mask = (1 << rbits) - 1;
-        using dist = std::uniform_int_distribution<byte>;
-        dist bd{0, 255};
-        dist md{0, (byte)mask};
-        do {
-            for (size_t i = 0; i < bytes; ++i) {
-                ret.bytes[i] = bd(g);
-            }
-            if (rbits) {
-                ret.bytes[bytes] = md(g);
-            }
-        } while (ret > upper);
+        if (size_t n = upper.significant_limbs()) limb::random_upto(ret.limbs, upper.limbs, n, g);
         return ret;
     }
 
+    // uniformly random in [lower, upper], the range is taken unsigned so that it may cover the whole width
+    template<typename G>
+    static constexpr wide_int random(G& g, wide_int const& lower, wide_int const& upper) {
+        if (upper < lower) throw std::invalid_argument("empty range");
+        return lower + wide_int(wide_int<BITS, false>::random(g, (upper - lower).to_unsigned()));
+    }
+
+    // fills every bit at random
     template<typename G>
-    static wide_int random(G g, wide_int lower, wide_int upper) {
-        return lower + random(g, upper - lower);
+    static constexpr void random_fill(std::span<wide_int> out, G& g) {
+        for (wide_int& x : out) limb::random_fill(x.limbs, LIMBS, g);
+    }
+
+    // fills with uniformly random numbers in [0, upper]
+    template<typename G>
+    static constexpr void random_fill(std::span<wide_int> out, G& g, wide_int const& upper) {
+        if (upper.is_negative()) throw std::invalid_argument("negative upper");
+        size_t n = upper.significant_limbs();
+        for (wide_int& x : out) {
+            limb::zero_n(x.limbs + n, LIMBS - n);
+            if (n) limb::random_upto(x.limbs, upper.limbs, n, g);
+        }
     }
 
     static constexpr wide_int from_string(const char* cp, int base = 10) {
@@ -460,15 +488,7 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
             case '-': neg = true;
             case '+': ++cp;
         }
-        wide_int ret;
-        while (char ch = *cp++) {
-            int num = int_base::from_char_raw(ch, base);
-            if (num < 0) throw std::invalid_argument("invalid string");
-            ret *= base;
-            ret += (unsigned) num;
-        }
-        if (neg) ret.negative();
-        return ret;
+        return parse(cp, cp + std::char_traits<char>::length(cp), base, neg);
     }
 
     static constexpr wide_int from_string_based(const char* cp) {
@@ -489,13 +509,16 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
                 if (base == 10) base = 8;
             } else --cp;
         } else --cp;
-        wide_int ret;
-        while (char ch = *cp++) {
-            int num = int_base::from_char_raw(ch, base);
-            if (num < 0) throw std::invalid_argument("invalid string");
-            ret *= base;
-            ret += (unsigned) num;
+        return parse(cp, cp + std::char_traits<char>::length(cp), base, neg);
+    }
+
+    // the digits in [first, last) without sign or prefix, truncated to the width
+    static constexpr wide_int parse(const char* first, const char* last, int base, bool neg = false) {
+        for (const char* it = first; it != last; ++it) {
+            if (int_base::from_char_raw(*it, base) < 0) throw std::invalid_argument("invalid string");
         }
+        wide_int ret;
+        radix::from_chars(ret.limbs, LIMBS, first, last, base);
         if (neg) ret.negative();
         return ret;
     }
@@ -527,7 +550,6 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
         if (f & std::ios::dec) base = 10;
         if (f & std::ios::hex) base = 16;
         bool neg = false;
-        wide_int ret;
         if (is) {
             switch (is.get()) {
                 case '-': neg = true;
@@ -535,24 +557,24 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
                 default: is.unget();
             }
         }
+        std::string digits;
         if (is && base == 16) {
             if (is.get() == '0') {
                 char ch = is.get();
-                if (!(ch == 'x' || ch == 'X')) is.unget();
+                if (!(ch == 'x' || ch == 'X')) {
+                    // a lone zero is a digit rather than a prefix
+                    is.unget();
+                    digits += '0';
+                }
             } else is.unget();
         }
-        bool read = false;
         while (is) {
             char ch = is.get();
-            int num = int_base::from_char_raw(ch, base);
-            if (num < 0) break;
-            read = true;
-            ret *= base;
-            ret += (unsigned) num;
+            if (int_base::from_char_raw(ch, base) < 0) break;
+            digits += ch;
         }
-        if (read) {
-            if (neg) ret.negative();
-            rhs = ret;    
+        if (!digits.empty()) {
+            rhs = parse(digits.data(), digits.data() + digits.size(), base, neg);
         } else {
             is.setstate(std::ios::failbit);
         }
@@ -561,10 +583,7 @@ YAO_MATH_WIDE_INT_SHIFT_OP(>>)
 
     constexpr int compare(wide_int const& rhs) const noexcept {
         if (int cmp = is_negative() - rhs.is_negative()) return -cmp;
-        for (size_t i = BYTES - 1; /* i >= 0 */ ~i; --i) {
-            if (int cmp = bytes[i] - rhs.bytes[i]) return cmp;
-        }
-        return 0;
+        return limb::cmp_n(limbs, rhs.limbs, LIMBS);
     }
 };
 
@@ -590,14 +609,15 @@ YAO_MATH_WIDE_INT_BINARY_OP(^)
 template<size_t N, bool S, size_t M, bool R>
 constexpr std::common_type_t<wide_int<N, S>, wide_int<M, R>> 
     operator*(wide_int<N, S> const& lhs, wide_int<M, R> const& rhs) noexcept {
-    std::common_type_t<wide_int<N, S>, wide_int<M, R>> ret;
-    for (size_t i = 0; i < lhs.BYTES; ++i) {
-        unsigned carry = 0;
-        for (size_t j = 0; j < rhs.BYTES && (i + j) < ret.BYTES; ++j) {
-            carry += ret.bytes[i + j] + lhs.bytes[i] * rhs.bytes[j];
-            ret.bytes[i + j] = carry & 0xFF;
-            carry >>= 8;
-        }
+    using type = std::common_type_t<wide_int<N, S>, wide_int<M, R>>;
+    type a = lhs, b = rhs, ret;
+    // only the low half of the product is kept, so the truncated variants suffice
+    constexpr size_t scratch = limb::mullo_scratch(type::LIMBS);
+    if constexpr (scratch == 0) {
+        limb::mullo_basecase(ret.limbs, a.limbs, b.limbs, type::LIMBS);
+    } else {
+        typename type::limb_type buf[scratch];
+        limb::mullo_n(ret.limbs, a.limbs, b.limbs, type::LIMBS, buf);
     }
     return ret;
 }
@@ -627,16 +647,77 @@ constexpr int compare(wide_int<N, S> const& lhs, wide_int<M, R> const& rhs) noex
     return ret.compare(rhs);
 }
 
+// the greatest common divisor of |x| and |y|, which is non-negative
 template<size_t N, bool S, size_t M, bool R>
 constexpr std::common_type_t<wide_int<N, S>, wide_int<M, R>>
-    gcd(wide_int<N, S> const& x, wide_int<M, R> const& y) {
-    return y ? gcd(y, x % y) : x;
+    gcd(wide_int<N, S> const& x, wide_int<M, R> const& y) noexcept {
+    using type = std::common_type_t<wide_int<N, S>, wide_int<M, R>>;
+    // the absolute values are taken before the conversion like std::gcd
+    wide_int<type::BITS, false> a = wide_int<N, false>(x.abs()), b = wide_int<M, false>(y.abs()), ret;
+    size_t an = a.significant_limbs(), bn = b.significant_limbs();
+    if (!an) return b;
+    if (!bn) return a;
+    typename type::limb_type scratch[limb::gcd_scratch(type::LIMBS)];
+    limb::gcd(ret.limbs, a.limbs, an, b.limbs, bn, scratch);
+    return ret;
 }
 
+// the least common multiple of |x| and |y|, which is non-negative
 template<size_t N, bool S, size_t M, bool R>
 constexpr std::common_type_t<wide_int<N, S>, wide_int<M, R>>
     lcm(wide_int<N, S> const& x, wide_int<M, R> const& y) {
-    return x / gcd(x, y) * y;
+    using type = std::common_type_t<wide_int<N, S>, wide_int<M, R>>;
+    if (!x || !y) return 0;
+    type a = wide_int<N, false>(x.abs()), b = wide_int<M, false>(y.abs());
+    return a / gcd(a, b) * b;
+}
+
+// the integral square root of x >= 0, by Newton's method from above
+template<size_t N, bool S>
+constexpr wide_int<N, S> isqrt(wide_int<N, S> const& x) {
+    if (x.is_negative()) throw std::invalid_argument("square root of a negative number");
+    wide_int<N, false> a = x.to_unsigned();
+    if (!a) return 0;
+    wide_int<N, false> r = wide_int<N, false>(1) << (a.bit_width() + 1) / 2;
+    while (true) {
+        wide_int<N, false> next = (r + a / r) >> 1;
+        if (next >= r) return r;
+        r = next;
+    }
+}
+
+// gcd = x * a + y * b with |x| <= |b| / gcd and |y| <= |a| / gcd
+template<size_t N>
+struct gcdext_t {
+    wide_int<N, false> gcd;
+    wide_int<N, true> x, y;
+};
+
+// the extended Euclidean algorithm, which gives the modular inverse
+template<size_t N, bool S, size_t M, bool R>
+constexpr gcdext_t<std::max(N, M)> gcdext(wide_int<N, S> const& a, wide_int<M, R> const& b) {
+    constexpr size_t K = std::max(N, M);
+    using stype = wide_int<K, true>;
+    wide_int<K, false> ua = wide_int<N, false>(a.abs()), ub = wide_int<M, false>(b.abs()), u = ua, v = ub;
+    // the coefficients of a of the remainders, those of b follow at the end
+    stype s0 = 1, s1 = 0;
+    while (v) {
+        auto d = u.div(v);
+        u = v;
+        v = d.rem;
+        stype s2 = s0 - stype(d.quot) * s1;
+        s0 = s1;
+        s1 = s2;
+    }
+    stype t = 0;
+    if (ub) {
+        // exact, but the product needs the double width
+        using wtype = wide_int<2 * K, true>;
+        t = (wtype(u) - wtype(s0) * wtype(ua)) / wtype(ub);
+    }
+    if (a.is_negative()) s0.negative();
+    if (b.is_negative()) t.negative();
+    return {u, s0, t};
 }
 
 
@@ -696,4 +777,6 @@ struct hash<yao_math::wide_int<N, S>> {
     }
 };
 
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,808 @@
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <compare>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "wide_int.cpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define YAO_MATH_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#ifndef YAO_MATH_WIDE_INT_ARRAY
+#define YAO_MATH_WIDE_INT_ARRAY
+
+/*
+ * element-wise kernels over a structure of arrays of numbers, where the i-th
+ * limb of all the elements is a contiguous plane a[i * stride, i * stride + count),
+ * so that the same limb of consecutive elements fills a vector register
+ *
+ * every kernel has a scalar version for any limb type, and 64-bit limbs also
+ * go through AVX2 or AVX-512 chosen at runtime; at compile time only the
+ * scalar versions run
+ */
+namespace yao_math::batch {
+
+enum class isa { scalar, avx2, avx512 };
+
+// the widest instruction set supported by this CPU
+inline isa supported() noexcept {
+#ifdef YAO_MATH_SIMD_X86
+    static const isa value = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return isa::avx512;
+        if (__builtin_cpu_supports("avx2")) return isa::avx2;
+        return isa::scalar;
+    }();
+    return value;
+#else
+    return isa::scalar;
+#endif
+}
+
+// the instruction set used by the kernels
+inline isa active = supported();
+
+// uses at most the given instruction set, returns the one in effect
+inline isa select(isa limit) noexcept {
+    return active = std::min(limit, supported());
+}
+
+enum class bit_op { and_, or_, xor_, not_ };
+
+using u64 = std::uint64_t;
+
+#ifdef YAO_MATH_SIMD_X86
+
+__attribute__((target("avx2")))
+inline __m256i load4(const u64* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2")))
+inline void store4(u64* p, __m256i x) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+}
+
+// x < y as unsigned, AVX2 only compares signed 64-bit lanes
+__attribute__((target("avx2")))
+inline __m256i less4(__m256i x, __m256i y) noexcept {
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+}
+
+// the AVX2 and AVX-512 kernels process whole blocks of 4 and 8 elements
+// and return how many elements they have done
+
+__attribute__((target("avx2")))
+inline size_t add_avx2(u64* r, const u64* a, const u64* b, size_t limbs, size_t stride, size_t count) noexcept {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // all ones in the lanes carrying
+        __m256i carry = _mm256_setzero_si256();
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            __m256i x = load4(a + k), s = _mm256_add_epi64(x, load4(b + k));
+            __m256i c = _mm256_or_si256(less4(s, x), _mm256_and_si256(carry, _mm256_cmpeq_epi64(s, ones)));
+            store4(r + k, _mm256_sub_epi64(s, carry));
+            carry = c;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+inline size_t sub_avx2(u64* r, const u64* a, const u64* b, size_t limbs, size_t stride, size_t count) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i borrow = zero;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            __m256i x = load4(a + k), y = load4(b + k), d = _mm256_sub_epi64(x, y);
+            __m256i c = _mm256_or_si256(less4(x, y), _mm256_and_si256(borrow, _mm256_cmpeq_epi64(d, zero)));
+            store4(r + k, _mm256_add_epi64(d, borrow));
+            borrow = c;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+inline size_t compare_avx2(std::int8_t* out, const u64* a, const u64* b, size_t limbs, size_t stride,
+                           size_t count, bool is_signed) noexcept {
+    const __m256i one = _mm256_set1_epi64x(1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i ret = _mm256_setzero_si256(), decided = ret;
+        for (size_t j = limbs; j--; ) {
+            size_t k = j * stride + i;
+            __m256i x = load4(a + k), y = load4(b + k), gt, lt;
+            if (is_signed && j == limbs - 1) {
+                gt = _mm256_cmpgt_epi64(x, y);
+                lt = _mm256_cmpgt_epi64(y, x);
+            } else {
+                gt = less4(y, x);
+                lt = less4(x, y);
+            }
+            // 1 for greater and -1 for less in the lanes not decided by a higher limb
+            ret = _mm256_or_si256(ret, _mm256_andnot_si256(decided, _mm256_or_si256(_mm256_and_si256(gt, one), lt)));
+            decided = _mm256_or_si256(decided, _mm256_or_si256(gt, lt));
+            if (_mm256_movemask_epi8(decided) == -1) break;
+        }
+        alignas(32) std::int64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), ret);
+        for (size_t t = 0; t < 4; ++t) out[i + t] = std::int8_t(lanes[t]);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+inline size_t bitwise_avx2(bit_op op, u64* r, const u64* a, const u64* b, size_t n) noexcept {
+    size_t i = 0;
+    switch (op) {
+    case bit_op::and_:
+        for (; i + 4 <= n; i += 4) store4(r + i, _mm256_and_si256(load4(a + i), load4(b + i)));
+        break;
+    case bit_op::or_:
+        for (; i + 4 <= n; i += 4) store4(r + i, _mm256_or_si256(load4(a + i), load4(b + i)));
+        break;
+    case bit_op::xor_:
+        for (; i + 4 <= n; i += 4) store4(r + i, _mm256_xor_si256(load4(a + i), load4(b + i)));
+        break;
+    case bit_op::not_: {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        for (; i + 4 <= n; i += 4) store4(r + i, _mm256_xor_si256(load4(a + i), ones));
+        break;
+    }
+    }
+    return i;
+}
+
+// r = a << (words * 64 + bits) where bits < 64, words may reach limbs
+__attribute__((target("avx2")))
+inline size_t shl_avx2(u64* r, const u64* a, size_t limbs, size_t stride, size_t count,
+                       size_t words, unsigned bits) noexcept {
+    // the vector shifts give 0 for a count of 64, so bits = 0 needs no branch
+    const __m128i up = _mm_cvtsi32_si128(int(bits)), down = _mm_cvtsi32_si128(int(64 - bits));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // downwards, so that r may be a
+        for (size_t j = limbs; j--; ) {
+            __m256i x = zero;
+            if (j >= words) {
+                x = _mm256_sll_epi64(load4(a + (j - words) * stride + i), up);
+                if (j > words) x = _mm256_or_si256(x, _mm256_srl_epi64(load4(a + (j - words - 1) * stride + i), down));
+            }
+            store4(r + j * stride + i, x);
+        }
+    }
+    return i;
+}
+
+// r = a >> (words * 64 + bits), filling with the sign of a if arithmetic
+__attribute__((target("avx2")))
+inline size_t shr_avx2(u64* r, const u64* a, size_t limbs, size_t stride, size_t count,
+                       size_t words, unsigned bits, bool arithmetic) noexcept {
+    const __m128i down = _mm_cvtsi32_si128(int(bits)), up = _mm_cvtsi32_si128(int(64 - bits));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i fill = arithmetic ? _mm256_cmpgt_epi64(zero, load4(a + (limbs - 1) * stride + i)) : zero;
+        // upwards, so that r may be a
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t src = j + words;
+            __m256i lo = src < limbs ? load4(a + src * stride + i) : fill;
+            __m256i hi = src + 1 < limbs ? load4(a + (src + 1) * stride + i) : fill;
+            store4(r + j * stride + i, _mm256_or_si256(_mm256_srl_epi64(lo, down), _mm256_sll_epi64(hi, up)));
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline __m512i load8(const u64* p) noexcept {
+    return _mm512_loadu_si512(p);
+}
+
+__attribute__((target("avx512f")))
+inline void store8(u64* p, __m512i x) noexcept {
+    _mm512_storeu_si512(p, x);
+}
+
+__attribute__((target("avx512f")))
+inline size_t add_avx512(u64* r, const u64* a, const u64* b, size_t limbs, size_t stride, size_t count) noexcept {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __mmask8 carry = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            __m512i x = load8(a + k), s = _mm512_add_epi64(x, load8(b + k));
+            __mmask8 c = _mm512_cmplt_epu64_mask(s, x) | (carry & _mm512_cmpeq_epi64_mask(s, ones));
+            store8(r + k, _mm512_mask_sub_epi64(s, carry, s, ones));
+            carry = c;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t sub_avx512(u64* r, const u64* a, const u64* b, size_t limbs, size_t stride, size_t count) noexcept {
+    const __m512i ones = _mm512_set1_epi64(-1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __mmask8 borrow = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            __m512i x = load8(a + k), y = load8(b + k), d = _mm512_sub_epi64(x, y);
+            __mmask8 c = _mm512_cmplt_epu64_mask(x, y) | (borrow & _mm512_cmpeq_epi64_mask(d, _mm512_setzero_si512()));
+            store8(r + k, _mm512_mask_add_epi64(d, borrow, d, ones));
+            borrow = c;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t compare_avx512(std::int8_t* out, const u64* a, const u64* b, size_t limbs, size_t stride,
+                             size_t count, bool is_signed) noexcept {
+    const __m512i one = _mm512_set1_epi64(1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __mmask8 greater = 0, less = 0;
+        for (size_t j = limbs; j--; ) {
+            size_t k = j * stride + i;
+            __m512i x = load8(a + k), y = load8(b + k);
+            __mmask8 gt, lt;
+            if (is_signed && j == limbs - 1) {
+                gt = _mm512_cmpgt_epi64_mask(x, y);
+                lt = _mm512_cmplt_epi64_mask(x, y);
+            } else {
+                gt = _mm512_cmpgt_epu64_mask(x, y);
+                lt = _mm512_cmplt_epu64_mask(x, y);
+            }
+            __mmask8 open = ~(greater | less);
+            greater |= gt & open;
+            less |= lt & open;
+            if (__mmask8(greater | less) == 0xFF) break;
+        }
+        __m512i ret = _mm512_mask_mov_epi64(_mm512_maskz_mov_epi64(greater, one), less, _mm512_set1_epi64(-1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm512_maskz_cvtepi64_epi8(0xFF, ret));
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t bitwise_avx512(bit_op op, u64* r, const u64* a, const u64* b, size_t n) noexcept {
+    size_t i = 0;
+    switch (op) {
+    case bit_op::and_:
+        for (; i + 8 <= n; i += 8) store8(r + i, _mm512_and_si512(load8(a + i), load8(b + i)));
+        break;
+    case bit_op::or_:
+        for (; i + 8 <= n; i += 8) store8(r + i, _mm512_or_si512(load8(a + i), load8(b + i)));
+        break;
+    case bit_op::xor_:
+        for (; i + 8 <= n; i += 8) store8(r + i, _mm512_xor_si512(load8(a + i), load8(b + i)));
+        break;
+    case bit_op::not_: {
+        const __m512i ones = _mm512_set1_epi64(-1);
+        for (; i + 8 <= n; i += 8) store8(r + i, _mm512_xor_si512(load8(a + i), ones));
+        break;
+    }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t shl_avx512(u64* r, const u64* a, size_t limbs, size_t stride, size_t count,
+                         size_t words, unsigned bits) noexcept {
+    const __m128i up = _mm_cvtsi32_si128(int(bits)), down = _mm_cvtsi32_si128(int(64 - bits));
+    const __m512i zero = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        for (size_t j = limbs; j--; ) {
+            __m512i x = zero;
+            if (j >= words) {
+                // the zero-masked forms over all 8 lanes, whose unmasked ones GCC takes for reading an uninitialized source
+                x = _mm512_maskz_sll_epi64(0xFF, load8(a + (j - words) * stride + i), up);
+                if (j > words) x = _mm512_or_si512(x, _mm512_maskz_srl_epi64(0xFF, load8(a + (j - words - 1) * stride + i), down));
+            }
+            store8(r + j * stride + i, x);
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t shr_avx512(u64* r, const u64* a, size_t limbs, size_t stride, size_t count,
+                         size_t words, unsigned bits, bool arithmetic) noexcept {
+    const __m128i down = _mm_cvtsi32_si128(int(bits)), up = _mm_cvtsi32_si128(int(64 - bits));
+    const __m512i zero = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i fill = arithmetic ? _mm512_maskz_srai_epi64(0xFF, load8(a + (limbs - 1) * stride + i), 63) : zero;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t src = j + words;
+            __m512i lo = src < limbs ? load8(a + src * stride + i) : fill;
+            __m512i hi = src + 1 < limbs ? load8(a + (src + 1) * stride + i) : fill;
+            store8(r + j * stride + i, _mm512_or_si512(_mm512_maskz_srl_epi64(0xFF, lo, down), _mm512_maskz_sll_epi64(0xFF, hi, up)));
+        }
+    }
+    return i;
+}
+
+#endif
+
+// the number of leading elements done by the vector kernels, the rest is left to the scalar ones
+#ifdef YAO_MATH_SIMD_X86
+#define YAO_MATH_BATCH_DISPATCH(L, done, kernel, ...)                       \
+    if constexpr (std::is_same_v<L, u64>) {                                 \
+        if (!std::is_constant_evaluated()) {                                \
+            if (active == isa::avx512) done = kernel##_avx512(__VA_ARGS__); \
+            else if (active == isa::avx2) done = kernel##_avx2(__VA_ARGS__);\
+        }                                                                   \
+    }
+#else
+#define YAO_MATH_BATCH_DISPATCH(L, done, kernel, ...)
+#endif
+
+// r = a + b for each element, modulo 2^(limbs * bits<L>)
+template<typename L>
+constexpr void add(L* r, const L* a, const L* b, size_t limbs, size_t stride, size_t count) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, add, r, a, b, limbs, stride, count)
+    for (; i < count; ++i) {
+        L carry = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            r[k] = limb::addc(a[k], b[k], carry);
+        }
+    }
+}
+
+// r = a - b for each element, modulo 2^(limbs * bits<L>)
+template<typename L>
+constexpr void sub(L* r, const L* a, const L* b, size_t limbs, size_t stride, size_t count) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, sub, r, a, b, limbs, stride, count)
+    for (; i < count; ++i) {
+        L borrow = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            r[k] = limb::subb(a[k], b[k], borrow);
+        }
+    }
+}
+
+// out = the sign of a - b for each element, the top limb is signed if is_signed
+template<typename L>
+constexpr void compare(std::int8_t* out, const L* a, const L* b, size_t limbs, size_t stride,
+                       size_t count, bool is_signed) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, compare, out, a, b, limbs, stride, count, is_signed)
+    for (; i < count; ++i) {
+        std::int8_t ret = 0;
+        for (size_t j = limbs; j-- && !ret; ) {
+            size_t k = j * stride + i;
+            L x = a[k], y = b[k];
+            if (is_signed && j == limbs - 1) {
+                // flipping the sign bit orders two's complement as unsigned
+                x ^= L(L(1) << (limb::bits<L> - 1));
+                y ^= L(L(1) << (limb::bits<L> - 1));
+            }
+            ret = std::int8_t((x > y) - (x < y));
+        }
+        out[i] = ret;
+    }
+}
+
+// r = a op b over n limbs, b is unused by not_
+template<typename L>
+constexpr void bitwise(bit_op op, L* r, const L* a, const L* b, size_t n) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, bitwise, op, r, a, b, n)
+    switch (op) {
+    case bit_op::and_: for (; i < n; ++i) r[i] = a[i] & b[i]; break;
+    case bit_op::or_:  for (; i < n; ++i) r[i] = a[i] | b[i]; break;
+    case bit_op::xor_: for (; i < n; ++i) r[i] = a[i] ^ b[i]; break;
+    case bit_op::not_: for (; i < n; ++i) r[i] = L(~a[i]); break;
+    }
+}
+
+// r = a << (words * bits<L> + bits) for each element, where bits < bits<L>,
+// r may be a
+template<typename L>
+constexpr void shl(L* r, const L* a, size_t limbs, size_t stride, size_t count,
+                   size_t words, unsigned bits) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, shl, r, a, limbs, stride, count, words, bits)
+    for (; i < count; ++i) {
+        for (size_t j = limbs; j--; ) {
+            L x = 0;
+            if (j >= words) {
+                x = L(a[(j - words) * stride + i] << bits);
+                if (bits && j > words) x |= a[(j - words - 1) * stride + i] >> (limb::bits<L> - bits);
+            }
+            r[j * stride + i] = x;
+        }
+    }
+}
+
+// r = a >> (words * bits<L> + bits) for each element, where bits < bits<L>,
+// filling with the sign of a if arithmetic; r may be a
+template<typename L>
+constexpr void shr(L* r, const L* a, size_t limbs, size_t stride, size_t count,
+                   size_t words, unsigned bits, bool arithmetic) noexcept {
+    size_t i = 0;
+    YAO_MATH_BATCH_DISPATCH(L, i, shr, r, a, limbs, stride, count, words, bits, arithmetic)
+    for (; i < count; ++i) {
+        L fill = arithmetic && (a[(limbs - 1) * stride + i] >> (limb::bits<L> - 1)) ? L(~L(0)) : L(0);
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t src = j + words;
+            L lo = src < limbs ? a[src * stride + i] : fill;
+            L hi = src + 1 < limbs ? a[(src + 1) * stride + i] : fill;
+            r[j * stride + i] = bits ? L(lo >> bits | L(hi << (limb::bits<L> - bits))) : lo;
+        }
+    }
+}
+
+/*
+ * r = a * m for each element, modulo 2^(limbs * bits<L>)
+ *
+ * neither AVX2 nor AVX-512F has a 64-bit multiply-high, and emulating it by
+ * four 32-bit products loses to the scalar 64x64 -> 128 multiply, so this one
+ * stays scalar
+ */
+template<typename L>
+constexpr void mul_1(L* r, const L* a, L m, size_t limbs, size_t stride, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        L carry = 0;
+        for (size_t j = 0; j < limbs; ++j) {
+            size_t k = j * stride + i;
+            L hi, c = 0;
+            L lo = limb::addc(limb::mul_wide(a[k], m, hi), carry, c);
+            r[k] = lo;
+            carry = L(hi + c);
+        }
+    }
+}
+
+#undef YAO_MATH_BATCH_DISPATCH
+
+}
+
+namespace yao_math {
+
+/*
+ * a vector of wide_int<N, S> stored as a structure of arrays, which runs the
+ * element-wise arithmetic on many numbers at once through yao_math::batch;
+ * the elements are read and written as plain wide_int
+ */
+template<size_t N, bool S>
+class wide_int_array {
+public:
+    using value_type = wide_int<N, S>;
+    using limb_type = typename value_type::limb_type;
+    constexpr static size_t LIMBS = value_type::LIMBS;
+
+    // assigns a wide_int to an element in place
+    class reference {
+        wide_int_array* array;
+        size_t index;
+
+        friend class wide_int_array;
+        constexpr reference(wide_int_array* array, size_t index) noexcept : array(array), index(index) {}
+
+    public:
+        constexpr operator value_type() const noexcept {
+            return array->get(index);
+        }
+
+        constexpr reference& operator=(value_type const& value) noexcept {
+            array->set(index, value);
+            return *this;
+        }
+
+        constexpr reference& operator=(reference const& rhs) noexcept {
+            return *this = rhs.value();
+        }
+
+        constexpr value_type value() const noexcept {
+            return array->get(index);
+        }
+
+        // the operators of wide_int are templates which do not look through the conversion
+
+        friend constexpr bool operator==(reference const& lhs, value_type const& rhs) noexcept {
+            return lhs.value() == rhs;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(reference const& lhs, value_type const& rhs) noexcept {
+            return lhs.value().compare(rhs) <=> 0;
+        }
+    };
+
+private:
+    // the planes are stride limbs apart and the elements beyond n are unspecified
+    std::vector<limb_type> data;
+    size_t n = 0, stride = 0;
+
+    // the stride for count elements; planes a multiple of 4 KiB apart would share
+    // the same L1 sets, so large ones are set off by a cache line each
+    constexpr static size_t padded(size_t count) noexcept {
+        constexpr size_t LINE = 64 / sizeof(limb_type), PAGE = 4096 / sizeof(limb_type);
+        if (count < PAGE) return (count + LINE - 1) / LINE * LINE;
+        return (count + PAGE - 1) / PAGE * PAGE + LINE;
+    }
+
+    constexpr void check_size(wide_int_array const& rhs) const {
+        if (n != rhs.n) throw std::invalid_argument("size mismatch");
+    }
+
+    // a result of the same size and stride whose limbs are about to be overwritten
+    constexpr wide_int_array like() const {
+        wide_int_array ret;
+        ret.n = n;
+        ret.stride = stride;
+        ret.data.resize(LIMBS * stride);
+        return ret;
+    }
+
+    // a copy whose planes are the given stride apart, as the kernels walk all their operands by one stride
+    constexpr wide_int_array repacked(size_t to) const {
+        wide_int_array ret;
+        ret.n = n;
+        ret.stride = to;
+        ret.data.resize(LIMBS * to);
+        for (size_t j = 0; j < LIMBS; ++j) std::copy_n(plane(j), n, ret.plane(j));
+        return ret;
+    }
+
+    constexpr void bitwise(batch::bit_op op, wide_int_array& r, wide_int_array const& rhs) const noexcept {
+        for (size_t j = 0; j < LIMBS; ++j) batch::bitwise(op, r.plane(j), plane(j), rhs.plane(j), n);
+    }
+
+    constexpr void shl(wide_int_array& r, size_t count) const noexcept {
+        count = std::min(count, N);
+        batch::shl(r.data.data(), data.data(), LIMBS, stride, n,
+                   count / value_type::LIMB_BITS, unsigned(count % value_type::LIMB_BITS));
+    }
+
+    constexpr void shr(wide_int_array& r, size_t count) const noexcept {
+        count = std::min(count, N);
+        batch::shr(r.data.data(), data.data(), LIMBS, stride, n,
+                   count / value_type::LIMB_BITS, unsigned(count % value_type::LIMB_BITS), S);
+    }
+
+public:
+    constexpr wide_int_array() noexcept = default;
+
+    constexpr explicit wide_int_array(size_t count) : data(LIMBS * padded(count)), n(count), stride(padded(count)) {}
+
+    constexpr wide_int_array(size_t count, value_type const& value) : wide_int_array(count) {
+        for (size_t j = 0; j < LIMBS; ++j) std::fill_n(plane(j), n, value.limbs[j]);
+    }
+
+    template<std::input_iterator It>
+    constexpr wide_int_array(It first, It last) {
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    constexpr wide_int_array(std::initializer_list<value_type> values)
+        : wide_int_array(values.begin(), values.end()) {}
+
+    constexpr size_t size() const noexcept {
+        return n;
+    }
+
+    constexpr bool empty() const noexcept {
+        return !n;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return stride;
+    }
+
+    // moves the planes apart for at least count elements
+    constexpr void reserve(size_t count) {
+        if (count > stride) *this = repacked(padded(count));
+    }
+
+    // new elements are 0
+    constexpr void resize(size_t count) {
+        if (count > stride) reserve(std::max(count, 2 * stride));
+        for (size_t j = 0; count > n && j < LIMBS; ++j) std::fill(plane(j) + n, plane(j) + count, limb_type(0));
+        n = count;
+    }
+
+    constexpr void clear() noexcept {
+        n = 0;
+    }
+
+    constexpr void push_back(value_type const& value) {
+        if (n == stride) reserve(2 * stride + 1);
+        set(n++, value);
+    }
+
+    constexpr value_type get(size_t i) const noexcept {
+        value_type ret;
+        for (size_t j = 0; j < LIMBS; ++j) ret.limbs[j] = data[j * stride + i];
+        return ret;
+    }
+
+    constexpr void set(size_t i, value_type const& value) noexcept {
+        for (size_t j = 0; j < LIMBS; ++j) data[j * stride + i] = value.limbs[j];
+    }
+
+    constexpr value_type operator[](size_t i) const noexcept {
+        return get(i);
+    }
+
+    constexpr reference operator[](size_t i) noexcept {
+        return reference(this, i);
+    }
+
+    constexpr value_type at(size_t i) const {
+        if (i >= n) throw std::out_of_range("wide_int_array index out of range");
+        return get(i);
+    }
+
+    // the j-th limb of all the elements
+    constexpr limb_type* plane(size_t j) noexcept {
+        return data.data() + j * stride;
+    }
+
+    constexpr const limb_type* plane(size_t j) const noexcept {
+        return data.data() + j * stride;
+    }
+
+    constexpr std::vector<value_type> to_vector() const {
+        std::vector<value_type> ret(n);
+        for (size_t i = 0; i < n; ++i) ret[i] = get(i);
+        return ret;
+    }
+
+    // the sign of lhs[i] - rhs[i] as wide_int::compare gives it
+    constexpr std::vector<std::int8_t> compare(wide_int_array const& rhs) const {
+        check_size(rhs);
+        if (stride != rhs.stride) return compare(rhs.repacked(stride));
+        std::vector<std::int8_t> ret(n);
+        batch::compare(ret.data(), data.data(), rhs.data.data(), LIMBS, stride, n, S);
+        return ret;
+    }
+
+    constexpr wide_int_array& operator+=(wide_int_array const& rhs) {
+        check_size(rhs);
+        if (stride != rhs.stride) return *this += rhs.repacked(stride);
+        batch::add(data.data(), data.data(), rhs.data.data(), LIMBS, stride, n);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator-=(wide_int_array const& rhs) {
+        check_size(rhs);
+        if (stride != rhs.stride) return *this -= rhs.repacked(stride);
+        batch::sub(data.data(), data.data(), rhs.data.data(), LIMBS, stride, n);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator*=(limb_type rhs) noexcept {
+        batch::mul_1(data.data(), data.data(), rhs, LIMBS, stride, n);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator&=(wide_int_array const& rhs) {
+        check_size(rhs);
+        bitwise(batch::bit_op::and_, *this, rhs);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator|=(wide_int_array const& rhs) {
+        check_size(rhs);
+        bitwise(batch::bit_op::or_, *this, rhs);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator^=(wide_int_array const& rhs) {
+        check_size(rhs);
+        bitwise(batch::bit_op::xor_, *this, rhs);
+        return *this;
+    }
+
+    constexpr wide_int_array& operator<<=(size_t rhs) noexcept {
+        shl(*this, rhs);
+        return *this;
+    }
+
+    // arithmetic for signed elements
+    constexpr wide_int_array& operator>>=(size_t rhs) noexcept {
+        shr(*this, rhs);
+        return *this;
+    }
+
+    constexpr wide_int_array operator~() const {
+        wide_int_array ret(like());
+        bitwise(batch::bit_op::not_, ret, *this);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator+(wide_int_array const& lhs, wide_int_array const& rhs) {
+        lhs.check_size(rhs);
+        if (lhs.stride != rhs.stride) return lhs + rhs.repacked(lhs.stride);
+        wide_int_array ret(lhs.like());
+        batch::add(ret.data.data(), lhs.data.data(), rhs.data.data(), LIMBS, lhs.stride, lhs.n);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator-(wide_int_array const& lhs, wide_int_array const& rhs) {
+        lhs.check_size(rhs);
+        if (lhs.stride != rhs.stride) return lhs - rhs.repacked(lhs.stride);
+        wide_int_array ret(lhs.like());
+        batch::sub(ret.data.data(), lhs.data.data(), rhs.data.data(), LIMBS, lhs.stride, lhs.n);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator*(wide_int_array const& lhs, limb_type rhs) {
+        wide_int_array ret(lhs.like());
+        batch::mul_1(ret.data.data(), lhs.data.data(), rhs, LIMBS, lhs.stride, lhs.n);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator*(limb_type lhs, wide_int_array const& rhs) {
+        return rhs * lhs;
+    }
+
+    friend constexpr wide_int_array operator&(wide_int_array const& lhs, wide_int_array const& rhs) {
+        lhs.check_size(rhs);
+        wide_int_array ret(lhs.like());
+        lhs.bitwise(batch::bit_op::and_, ret, rhs);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator|(wide_int_array const& lhs, wide_int_array const& rhs) {
+        lhs.check_size(rhs);
+        wide_int_array ret(lhs.like());
+        lhs.bitwise(batch::bit_op::or_, ret, rhs);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator^(wide_int_array const& lhs, wide_int_array const& rhs) {
+        lhs.check_size(rhs);
+        wide_int_array ret(lhs.like());
+        lhs.bitwise(batch::bit_op::xor_, ret, rhs);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator<<(wide_int_array const& lhs, size_t rhs) {
+        wide_int_array ret(lhs.like());
+        lhs.shl(ret, rhs);
+        return ret;
+    }
+
+    friend constexpr wide_int_array operator>>(wide_int_array const& lhs, size_t rhs) {
+        wide_int_array ret(lhs.like());
+        lhs.shr(ret, rhs);
+        return ret;
+    }
+
+    friend constexpr bool operator==(wide_int_array const& lhs, wide_int_array const& rhs) noexcept {
+        if (lhs.n != rhs.n) return false;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            if (!std::equal(lhs.plane(j), lhs.plane(j) + lhs.n, rhs.plane(j))) return false;
+        }
+        return true;
+    }
+};
+
+}
+
+#endif
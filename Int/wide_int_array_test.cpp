@@ -0,0 +1,75 @@
+#include "wide_int_array.cpp"
+
+#include <iostream>
+#include <random>
+
+using yao_math::wide_int_array;
+
+// the bulk operations agree with wide_int element by element
+template<size_t N, bool S>
+constexpr bool agrees(size_t count) {
+    using T = yao_math::wide_int<N, S>;
+    wide_int_array<N, S> a, b;
+    T x = T(1) - T(3), y = T(7);
+    for (size_t i = 0; i < count; ++i) {
+        a.push_back(x);
+        b.push_back(i % 5 ? y : x);
+        x = x * T(0x9E3779B97F4A7C15ull) + T(i);
+        y = (y << 13) ^ (y >> 7) ^ x;
+    }
+    auto sum = a + b, diff = a - b, conj = a & b, disj = a | b, excl = a ^ b, inv = ~a;
+    auto m = typename wide_int_array<N, S>::limb_type(0x9E3779B97F4A7C15ull);
+    auto prod = a * m, left = a << (N / 3), right = a >> (N / 3 + 1), all = a >> N;
+    auto cmp = a.compare(b);
+    for (size_t i = 0; i < count; ++i) {
+        T p = a[i], q = b[i];
+        if (sum[i] != p + q || diff[i] != p - q) return false;
+        if (conj[i] != (p & q) || disj[i] != (p | q) || excl[i] != (p ^ q) || inv[i] != ~p) return false;
+        if (prod[i] != p * T(m) || left[i] != p << (N / 3) || right[i] != p >> (N / 3 + 1)) return false;
+        if (all[i] != (p.is_negative() ? T(0) - T(1) : T(0))) return false;
+        if (cmp[i] != p.compare(q)) return false;
+    }
+    return true;
+}
+
+static_assert(agrees<256, false>(11));
+static_assert(agrees<256, true>(11));
+static_assert(agrees<24, true>(5));
+static_assert(agrees<96, false>(5));
+
+// element access through the proxy, and operands of different capacities
+static_assert([] {
+    wide_int_array<128, true> a(3), b{1, 2, 3};
+    a[1] = yao_math::sint128(-5);
+    a[2] = b[0];
+    a += b;
+    return a.at(0) == yao_math::sint128(1) && a[1] == yao_math::sint128(-3) && a[2] == yao_math::sint128(4) && a.size() == 3;
+}());
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    // the vector kernels against the scalar ones on odd sizes that leave a tail
+    mt19937_64 g(20221017);
+    bool ok = true;
+    wide_int_array<512, true> a, b;
+    for (size_t i = 0; i < 1003; ++i) {
+        sint512 x, y;
+        for (auto& l : x.limbs) l = g();
+        for (auto& l : y.limbs) l = i % 3 ? g() : l;
+        a.push_back(x);
+        b.push_back(i % 7 ? y : x);
+    }
+    auto run = [&] {
+        return vector{(a + b).to_vector(), (a - b).to_vector(), (a ^ b).to_vector(),
+                      (a << 100).to_vector(), (a >> 130).to_vector()};
+    };
+    auto scalar_cmp = (batch::select(batch::isa::scalar), a.compare(b));
+    auto scalar = run();
+    for (auto level : {batch::isa::avx2, batch::isa::avx512}) {
+        if (batch::select(level) != level) continue;
+        ok = ok && run() == scalar && a.compare(b) == scalar_cmp;
+        cout << (level == batch::isa::avx2 ? "avx2" : "avx512") << (ok ? " ok" : " mismatch") << endl;
+    }
+    return !ok;
+}
@@ -0,0 +1,656 @@
+#include "wide_int.cpp"
+#include "modular.cpp"
+#include "wide_int_array.cpp"
+#include "big_int.cpp"
+#include "divisor.cpp"
+#include "wide_prime.cpp"
+#include "benchmark.cpp"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <string>
+
+using namespace yao_math;
+
+// the original byte-at-a-time arithmetic of wide_int, kept as the baseline
+template<size_t BYTES>
+struct byte_int {
+    byte bytes[BYTES];
+
+    byte_int& operator+=(byte_int const& rhs) {
+        unsigned carry = 0;
+        for (size_t i = 0; i < BYTES; ++i) {
+            carry += bytes[i] + rhs.bytes[i];
+            bytes[i] = carry & 0xFF;
+            carry >>= 8;
+        }
+        return *this;
+    }
+
+    friend byte_int operator*(byte_int const& lhs, byte_int const& rhs) {
+        byte_int ret{};
+        for (size_t i = 0; i < BYTES; ++i) {
+            unsigned carry = 0;
+            for (size_t j = 0; (i + j) < BYTES; ++j) {
+                carry += ret.bytes[i + j] + lhs.bytes[i] * rhs.bytes[j];
+                ret.bytes[i + j] = carry & 0xFF;
+                carry >>= 8;
+            }
+        }
+        return ret;
+    }
+
+    int compare(byte_int const& rhs) const {
+        for (size_t i = BYTES - 1; /* i >= 0 */ ~i; --i) {
+            if (int cmp = bytes[i] - rhs.bytes[i]) return cmp;
+        }
+        return 0;
+    }
+
+    byte_int& operator<<=(size_t rhs) {
+        size_t rbyte = rhs >> 3;
+        size_t rbit = rhs & 7;
+        rbyte = std::min(rbyte, BYTES);
+        std::memmove(bytes + rbyte, bytes, BYTES - rbyte);
+        std::memset(bytes, 0, rbyte);
+        if (!rbit) return *this;
+        for (size_t i = BYTES - 1; i >= rbyte && /* i >= 0 */ ~i; --i) {
+            byte rem = bytes[i] >> (8 - rbit);
+            bytes[i] <<= rbit;
+            if (i + 1 < BYTES) {
+                bytes[i + 1] |= rem;
+            }
+        }
+        return *this;
+    }
+
+};
+
+template<size_t N>
+using uint_t = wide_int<N, false>;
+
+template<size_t N>
+using sint_t = wide_int<N, true>;
+
+// the original shift-and-subtract division of wide_int for non-negative operands
+template<size_t N, bool S>
+wide_int<N, S> shift_subtract_div(wide_int<N, S> rem, wide_int<N, S> const& rhs) {
+    size_t rbits = rhs.log2();
+    wide_int<N, S> qout;
+    int cmp;
+    while ((cmp = rem.compare(rhs)) > 0) {
+        size_t bits = rem.log2();
+        size_t shift = bits - rbits;
+        wide_int<N, S> q = rhs << shift;
+        if (q > rem && shift) {
+            --shift;
+            q >>= 1;
+        }
+        rem -= q;
+        qout += wide_int<N, S>::exp2(shift);
+    }
+    if (cmp == 0) {
+        ++qout;
+    }
+    return qout;
+}
+
+// the original digit-at-a-time radix conversion of wide_int
+template<size_t N, bool S>
+std::string digit_to_string(wide_int<N, S> const& x, int base) {
+    std::string buf;
+    typename wide_int<N, S>::div_t d = {x.abs(), 0};
+    do {
+        d = d.quot.div(base);
+        buf += int_base::to_char_raw(d.rem.to_byte(), base);
+    } while (d.quot);
+    if (x.is_negative()) buf += '-';
+    return {buf.rbegin(), buf.rend()};
+}
+
+template<size_t N, bool S>
+wide_int<N, S> digit_from_string(const char* cp, int base) {
+    wide_int<N, S> ret;
+    while (char ch = *cp++) {
+        ret *= base;
+        ret += (unsigned) int_base::from_char_raw(ch, base);
+    }
+    return ret;
+}
+
+constexpr size_t SAMPLES = 64;
+
+template<typename F>
+double measure(F f, size_t rounds) {
+    f(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i) f();
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> time = stop - start;
+    return time.count() / rounds / SAMPLES;
+}
+
+template<typename T, size_t BYTES>
+std::vector<T> samples(std::mt19937_64& g) {
+    std::vector<T> ret(SAMPLES);
+    for (T& t : ret) {
+        byte raw[BYTES];
+        for (byte& b : raw) b = g();
+        if constexpr (requires { t.bytes; }) {
+            std::memcpy(t.bytes, raw, BYTES);
+        } else {
+            for (size_t i = 0; i < BYTES; ++i) t.set_byte(i, raw[i]);
+        }
+    }
+    return ret;
+}
+
+enum class op_t { add, mul, compare, shift };
+
+template<op_t op, typename T, size_t BYTES>
+double run(std::mt19937_64& g) {
+    auto xs = samples<T, BYTES>(g), ys = samples<T, BYTES>(g);
+    // equal numbers make compare scan the full width
+    if constexpr (op == op_t::compare) ys = xs;
+    size_t rounds = std::max<size_t>(1, (op == op_t::mul ? 1 << 16 : 1 << 20) / BYTES);
+    return measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            if constexpr (op == op_t::add) {
+                T t = xs[i];
+                t += ys[i];
+                do_not_optimize(t);
+            } else if constexpr (op == op_t::mul) {
+                T t = xs[i] * ys[i];
+                do_not_optimize(t);
+            } else if constexpr (op == op_t::compare) {
+                do_not_optimize(xs[i].compare(ys[i]));
+            } else if constexpr (op == op_t::shift) {
+                T t = xs[i];
+                t <<= (i * 37) % (BYTES << 3);
+                do_not_optimize(t);
+            }
+        }
+    }, rounds);
+}
+
+template<size_t N, op_t op>
+void bench(const char* what, std::mt19937_64& g) {
+    constexpr size_t BYTES = N >> 3;
+    double before = run<op, byte_int<BYTES>, BYTES>(g);
+    double after = run<op, uint_t<N>, BYTES>(g);
+    std::cout << "uint" << std::left << std::setw(6) << N
+              << std::setw(9) << what << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << before << "ns"
+              << std::setw(12) << after << "ns"
+              << std::setw(10) << before / after << "x" << std::endl;
+}
+
+template<size_t N>
+void bench(std::mt19937_64& g) {
+    bench<N, op_t::add>("add", g);
+    bench<N, op_t::mul>("mul", g);
+    bench<N, op_t::compare>("compare", g);
+    bench<N, op_t::shift>("shift", g);
+}
+
+// schoolbook against the size-dispatched engine, full and truncated products
+template<size_t N>
+void bench_mul(std::mt19937_64& g) {
+    using limb_type = typename uint_t<N>::limb_type;
+    constexpr size_t LIMBS = uint_t<N>::LIMBS;
+    auto xs = samples<uint_t<N>, N / 8>(g), ys = samples<uint_t<N>, N / 8>(g);
+    size_t rounds = std::max<size_t>(1, (1 << 20) / N);
+    limb_type full[2 * LIMBS], low[LIMBS];
+    limb_type scratch[limb::mul_scratch(LIMBS) + limb::mullo_scratch(LIMBS) + 1];
+    auto time = [&](auto f) {
+        return measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) {
+                f(xs[i].limbs, ys[i].limbs);
+            }
+        }, rounds);
+    };
+    double basecase = time([&](auto a, auto b) {
+        limb::mul_basecase(full, a, LIMBS, b, LIMBS);
+        do_not_optimize(full);
+    });
+    double dispatched = time([&](auto a, auto b) {
+        limb::mul_n(full, a, b, LIMBS, scratch);
+        do_not_optimize(full);
+    });
+    double lo_basecase = time([&](auto a, auto b) {
+        limb::mullo_basecase(low, a, b, LIMBS);
+        do_not_optimize(low);
+    });
+    double lo_dispatched = time([&](auto a, auto b) {
+        limb::mullo_n(low, a, b, LIMBS, scratch);
+        do_not_optimize(low);
+    });
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << basecase << "ns"
+              << std::setw(12) << dispatched << "ns"
+              << std::setw(12) << lo_basecase << "ns"
+              << std::setw(12) << lo_dispatched << "ns" << std::endl;
+}
+
+// dividends of full width over divisors of a single limb, a quarter and a half of the width
+template<size_t N, bool S>
+void bench_div(std::mt19937_64& g) {
+    using type = wide_int<N, S>;
+    auto xs = samples<type, N / 8>(g), ys = samples<type, N / 8>(g);
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        // the old algorithm only copes with non-negative numbers
+        size_t bits = i % 3 == 0 ? 60 : i % 3 == 1 ? N / 4 : N / 2;
+        xs[i] = uint_t<N>(xs[i]) >> 1;
+        ys[i] = uint_t<N>(ys[i]) >> (N - bits);
+        if (!ys[i]) ys[i] = 7;
+    }
+    size_t rounds = std::max<size_t>(1, (1 << 14) / N);
+    double before = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            do_not_optimize(shift_subtract_div(xs[i], ys[i]));
+        }
+    }, rounds);
+    if constexpr (S) {
+        // mix the signs for the new algorithm
+        for (size_t i = 0; i < SAMPLES; i += 2) xs[i].negative();
+        for (size_t i = 0; i < SAMPLES; i += 3) ys[i].negative();
+    }
+    double after = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            do_not_optimize(xs[i].div(ys[i]));
+        }
+    }, rounds * 16);
+    std::cout << (S ? "sint" : "uint") << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << before << "ns"
+              << std::setw(12) << after << "ns"
+              << std::setw(10) << before / after << "x" << std::endl;
+}
+
+// decimal and hexadecimal round trips of full width numbers
+template<size_t N>
+void bench_radix(std::mt19937_64& g) {
+    auto xs = samples<uint_t<N>, N / 8>(g);
+    size_t rounds = std::max<size_t>(1, (1 << 12) / N);
+    for (int base : {10, 16}) {
+        std::vector<std::string> strs;
+        for (auto const& x : xs) strs.push_back(x.to_string(base));
+        double to_before = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(digit_to_string(xs[i], base));
+        }, rounds);
+        double to_after = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(xs[i].to_string(base));
+        }, rounds * 16);
+        double from_before = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(digit_from_string<N, false>(strs[i].c_str(), base));
+        }, rounds);
+        double from_after = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(uint_t<N>::from_string(strs[i].c_str(), base));
+        }, rounds * 16);
+        std::cout << "uint" << std::left << std::setw(6) << N << std::setw(4) << base << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(14) << to_before << "ns" << std::setw(12) << to_after << "ns"
+                  << std::setw(8) << to_before / to_after << "x"
+                  << std::setw(14) << from_before << "ns" << std::setw(12) << from_after << "ns"
+                  << std::setw(8) << from_before / from_after << "x" << std::endl;
+    }
+}
+
+// division by the same divisor: each time from scratch, by a divisor object and by a constant
+template<size_t N, uint_t<N> D>
+void bench_divisor(std::mt19937_64& g, char const* name) {
+    auto xs = samples<uint_t<N>, N / 8>(g);
+    divisor<uint_t<N>> d(D);
+    size_t rounds = std::max<size_t>(1, (1 << 15) / N);
+    double plain = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(xs[i].div(D));
+    }, rounds);
+    double object = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(d.divrem(xs[i]));
+    }, rounds);
+    double constant = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(xs[i] / constant_divisor<uint_t<N>, D>{});
+    }, rounds);
+    double rem = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(xs[i] % constant_divisor<uint_t<N>, D>{});
+    }, rounds);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::setw(10) << name << std::right
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << plain << "ns" << std::setw(10) << object << "ns"
+              << std::setw(10) << constant << "ns" << std::setw(10) << rem << "ns"
+              << std::setw(10) << plain / constant << "x" << std::endl;
+}
+
+// the conversion through the decimal digits, which rounds correctly
+template<size_t N>
+double digit_to_double(uint_t<N> const& x) {
+    return std::strtod(x.to_string().c_str(), nullptr);
+}
+
+// the original conversion shifting the whole number down to the top limb, which rounds twice
+template<size_t N>
+double shift_to_double(uint_t<N> const& x) {
+    int shift = std::max(int(x.bit_width()) - 64, 0);
+    return std::ldexp(double((x >> shift).template to_integral<std::uint64_t>()), shift);
+}
+
+template<size_t N>
+void bench_float(std::mt19937_64& g) {
+    auto xs = samples<uint_t<N>, N / 8>(g);
+    std::vector<double> ds;
+    for (auto const& x : xs) ds.push_back(x.template to_float<double>() / 2);
+    size_t rounds = std::max<size_t>(1, (1 << 14) / N);
+    double digit = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(digit_to_double(xs[i]));
+    }, rounds);
+    double shift = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(shift_to_double(xs[i]));
+    }, rounds * 64);
+    double to = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(xs[i].template to_float<double>());
+    }, rounds * 64);
+    double from = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(uint_t<N>::from_float(ds[i]));
+    }, rounds * 64);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << digit << "ns" << std::setw(10) << shift << "ns"
+              << std::setw(10) << to << "ns" << std::setw(10) << from << "ns"
+              << std::setw(10) << digit / to << "x" << std::endl;
+}
+
+// the original sampling through a distribution per limb, rejecting the whole number when it passes upper
+template<size_t N>
+uint_t<N> distribution_random(std::mt19937_64& g, uint_t<N> const& upper) {
+    using T = uint_t<N>;
+    uint_t<N> ret;
+    size_t bits = upper.bit_width();
+    size_t top = (bits - 1) / T::LIMB_BITS;
+    auto mask = T::LIMB_MAX >> (T::LIMB_BITS - ((bits - 1) % T::LIMB_BITS + 1));
+    std::uniform_int_distribution<unsigned long long> ld{0, T::LIMB_MAX};
+    do {
+        for (size_t i = 0; i < top; ++i) ret.limbs[i] = ld(g);
+        ret.limbs[top] = ld(g) & mask;
+    } while (ret > upper);
+    return ret;
+}
+
+// numbers below a bound just over a power of two, the worst case of masking
+template<size_t N>
+void bench_random(std::mt19937_64& g) {
+    uint_t<N> upper = (uint_t<N>(1) << (N - 2)) + uint_t<N>(1);
+    std::vector<uint_t<N>> xs(SAMPLES);
+    size_t rounds = std::max<size_t>(1, (1 << 16) / N);
+    double before = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) xs[i] = distribution_random(g, upper);
+        do_not_optimize(xs);
+    }, rounds);
+    double after = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) xs[i] = uint_t<N>::random(g, upper);
+        do_not_optimize(xs);
+    }, rounds);
+    double bulk = measure([&] {
+        uint_t<N>::random_fill(xs, g, upper);
+        do_not_optimize(xs);
+    }, rounds);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << before << "ns" << std::setw(10) << after << "ns"
+              << std::setw(10) << bulk << "ns" << std::setw(10) << before / bulk << "x" << std::endl;
+}
+
+// square-and-multiply reducing each product of the double width by operator%
+template<size_t N>
+uint_t<N> remainder_powmod(uint_t<N> const& x, uint_t<N> const& e, uint_t<N> const& m) {
+    uint_t<2 * N> ret = 1, base = x % m, mod = m;
+    for (size_t i = e.log2(); /* i >= 0 */ ~i; --i) {
+        ret = ret * ret % mod;
+        if (e.limbs[i / e.LIMB_BITS] >> (i % e.LIMB_BITS) & 1) ret = ret * base % mod;
+    }
+    return ret;
+}
+
+// the original Euclid on operator%, unrolled since the recursion overflows the stack at 8192 bits
+template<size_t N, bool S>
+wide_int<N, S> euclid_gcd(wide_int<N, S> x, wide_int<N, S> y) {
+    while (y) {
+        x = x % y;
+        std::swap(x, y);
+    }
+    return x;
+}
+
+// Baillie-PSW on random odd candidates of the full width, and next_prime from random starts
+template<size_t N>
+void bench_prime(std::mt19937_64& g, size_t searches) {
+    auto xs = samples<uint_t<N>, N / 8>(g);
+    for (auto& x : xs) x |= uint_t<N>(1) | uint_t<N>(1) << (N - 1);
+    double candidate = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(is_probable_prime(xs[i]));
+    }, 1);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << candidate / 1000 << "us" << std::setw(14) << 1e9 / candidate << "/s";
+    if (searches) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < searches; ++i) do_not_optimize(next_prime(xs[i] >> 1));
+        std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        std::cout << std::setw(12) << time.count() / searches << "ms";
+    }
+    std::cout << std::endl;
+}
+
+// Euclid against the binary algorithm alone and the Lehmer dispatch
+template<size_t N>
+void bench_gcd(std::mt19937_64& g) {
+    auto xs = samples<uint_t<N>, N / 8>(g), ys = samples<uint_t<N>, N / 8>(g);
+    size_t rounds = std::max<size_t>(1, (1 << 16) / N / N * 64);
+    double before = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(euclid_gcd(xs[i], ys[i]));
+    }, rounds);
+    double binary = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) {
+            uint_t<N> a = xs[i], b = ys[i], r;
+            limb::gcd_binary(r.limbs, a.limbs, a.significant_limbs(), b.limbs, b.significant_limbs());
+            do_not_optimize(r);
+        }
+    }, rounds);
+    double after = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(gcd(xs[i], ys[i]));
+    }, rounds);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << before / 1000 << "us"
+              << std::setw(12) << binary / 1000 << "us"
+              << std::setw(12) << after / 1000 << "us"
+              << std::setw(10) << before / after << "x" << std::endl;
+}
+
+// full width exponents modulo odd full width moduli
+template<size_t N>
+void bench_powmod(std::mt19937_64& g) {
+    auto xs = samples<uint_t<N>, N / 8>(g), es = samples<uint_t<N>, N / 8>(g), ms = samples<uint_t<N>, N / 8>(g);
+    for (auto& m : ms) m.limbs[0] |= 1;
+    size_t rounds = std::max<size_t>(1, (1 << 14) / N / N);
+    double before = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(remainder_powmod(xs[i], es[i], ms[i]));
+    }, rounds);
+    double montgomery = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(montgomery_context<N>(ms[i]).powmod(xs[i], es[i]));
+    }, rounds);
+    double barrett = measure([&] {
+        for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(barrett_context<N>(ms[i]).powmod(xs[i], es[i]));
+    }, rounds);
+    std::cout << "uint" << std::left << std::setw(6) << N << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << before / 1000 << "us"
+              << std::setw(12) << montgomery / 1000 << "us"
+              << std::setw(12) << barrett / 1000 << "us"
+              << std::setw(10) << before / montgomery << "x" << std::endl;
+}
+
+// numbers of BITS held in uint8192 "to be safe", in big_int and in big_int on an arena
+template<size_t BITS>
+void bench_big_int(std::mt19937_64& g) {
+    auto xs = samples<uint_t<8192>, BITS / 8>(g), ys = samples<uint_t<8192>, BITS / 8>(g);
+    std::vector<big_int> bxs, bys;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        bxs.emplace_back(xs[i]);
+        bys.emplace_back(ys[i]);
+    }
+    std::vector<std::byte> buffer(1 << 20);
+    size_t rounds = 1 << 10;
+    for (op_t op : {op_t::add, op_t::mul}) {
+        double fixed = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(op == op_t::add ? xs[i] + ys[i] : xs[i] * ys[i]);
+        }, rounds / 16);
+        double dynamic = measure([&] {
+            for (size_t i = 0; i < SAMPLES; ++i) do_not_optimize(op == op_t::add ? bxs[i] + bys[i] : bxs[i] * bys[i]);
+        }, rounds);
+        double arena = measure([&] {
+            std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+            for (size_t i = 0; i < SAMPLES; ++i) {
+                yao_math::pmr::big_int x(bxs[i], &resource), y(bys[i], &resource);
+                do_not_optimize(op == op_t::add ? x += y : x *= y);
+            }
+        }, rounds);
+        std::cout << std::setw(6) << BITS << "    " << std::left << std::setw(6) << (op == op_t::add ? "add" : "mul")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << fixed << "ns" << std::setw(10) << dynamic << "ns"
+                  << std::setw(10) << arena << "ns" << std::setw(10) << fixed / dynamic << "x" << std::endl;
+    }
+}
+
+constexpr size_t ARRAY = 4096;
+
+// in-place bulk operations by a loop over wide_int against wide_int_array
+// at each instruction set, in ns per element
+template<size_t N>
+void bench_array(std::mt19937_64& g) {
+    std::vector<uint_t<N>> xs(ARRAY), ys(ARRAY);
+    for (auto& x : xs) for (auto& l : x.limbs) l = g();
+    for (auto& y : ys) for (auto& l : y.limbs) l = g();
+    wide_int_array<N, false> a(xs.begin(), xs.end()), b(ys.begin(), ys.end());
+    std::vector<std::int8_t> cmp(ARRAY);
+    size_t rounds = std::max<size_t>(1, (1 << 24) / N / ARRAY);
+    auto per_element = [&](auto f) { return measure(f, rounds) * SAMPLES / ARRAY; };
+    for (op_t op : {op_t::add, op_t::compare, op_t::shift, op_t::mul}) {
+        double loop = per_element([&] {
+            for (size_t i = 0; i < ARRAY; ++i) {
+                if (op == op_t::add) xs[i] += ys[i];
+                else if (op == op_t::compare) cmp[i] = std::int8_t(xs[i].compare(ys[i]));
+                else if (op == op_t::shift) xs[i] <<= 7;
+                else xs[i] *= uint_t<N>(0x9E3779B97F4A7C15ull);
+            }
+            do_not_optimize(xs.data());
+            do_not_optimize(cmp.data());
+        });
+        std::cout << "uint" << std::left << std::setw(6) << N
+                  << std::setw(9) << (op == op_t::add ? "add" : op == op_t::compare ? "compare" : op == op_t::shift ? "shift" : "mul")
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(9) << loop << "ns";
+        for (auto level : {batch::isa::scalar, batch::isa::avx2, batch::isa::avx512}) {
+            if (batch::select(level) != level) {
+                std::cout << std::setw(11) << "-";
+                continue;
+            }
+            double bulk = per_element([&] {
+                if (op == op_t::add) a += b;
+                else if (op == op_t::compare) do_not_optimize(a.compare(b).data());
+                else if (op == op_t::shift) a <<= 7;
+                else a *= 0x9E3779B97F4A7C15ull;
+                do_not_optimize(a.plane(0));
+            });
+            std::cout << std::setw(9) << bulk << "ns";
+        }
+        std::cout << std::endl;
+    }
+    batch::select(batch::isa::avx512);
+}
+
+int main() {
+    std::mt19937_64 g(20221017);
+    std::cout << "width     op         byte-wise  limb-wise   speedup" << std::endl;
+    bench<128>(g);
+    bench<256>(g);
+    bench<512>(g);
+    bench<1024>(g);
+    bench<2048>(g);
+    bench<4096>(g);
+    bench<8192>(g);
+    std::cout << std::endl;
+    std::cout << "width       schoolbook  dispatched  low-school  low-dispatched" << std::endl;
+    bench_mul<512>(g);
+    bench_mul<1024>(g);
+    bench_mul<2048>(g);
+    bench_mul<4096>(g);
+    bench_mul<8192>(g);
+    std::cout << std::endl;
+    std::cout << "width      shift-subtract  long-div   speedup" << std::endl;
+    bench_div<128, false>(g);
+    bench_div<128, true>(g);
+    bench_div<256, false>(g);
+    bench_div<256, true>(g);
+    bench_div<512, false>(g);
+    bench_div<512, true>(g);
+    bench_div<1024, false>(g);
+    bench_div<1024, true>(g);
+    bench_div<2048, false>(g);
+    bench_div<2048, true>(g);
+    bench_div<4096, false>(g);
+    bench_div<4096, true>(g);
+    bench_div<8192, false>(g);
+    bench_div<8192, true>(g);
+    std::cout << std::endl;
+    std::cout << "width     base  digit-to-string   to_string        digit-from-string  from_string" << std::endl;
+    bench_radix<128>(g);
+    bench_radix<512>(g);
+    bench_radix<2048>(g);
+    bench_radix<8192>(g);
+    bench_radix<32768>(g);
+    std::cout << std::endl;
+    std::cout << "width     divisor        div      divisor   constant   constant%   speedup" << std::endl;
+    bench_divisor<256, uint_t<256>(10)>(g, "10");
+    bench_divisor<256, uint_t<256>(10000000000000000000ull)>(g, "10^19");
+    bench_divisor<512, (uint_t<512>(1) << 127) - uint_t<512>(1)>(g, "2^127-1");
+    bench_divisor<4096, uint_t<4096>(1000000007)>(g, "1e9+7");
+    std::cout << std::endl;
+    std::cout << "width     digit-based   shift     to_float  from_float   speedup" << std::endl;
+    bench_float<128>(g);
+    bench_float<256>(g);
+    bench_float<1024>(g);
+    bench_float<8192>(g);
+    std::cout << std::endl;
+    std::cout << "width     distribution  random    random_fill  speedup" << std::endl;
+    bench_random<64>(g);
+    bench_random<256>(g);
+    bench_random<512>(g);
+    bench_random<4096>(g);
+    std::cout << std::endl;
+    std::cout << "width     remainder      montgomery  barrett       speedup" << std::endl;
+    bench_powmod<256>(g);
+    bench_powmod<512>(g);
+    bench_powmod<1024>(g);
+    bench_powmod<2048>(g);
+    std::cout << std::endl;
+    std::cout << "width     candidate   candidates    next_prime" << std::endl;
+    bench_prime<512>(g, 16);
+    bench_prime<1024>(g, 8);
+    bench_prime<2048>(g, 4);
+    bench_prime<4096>(g, 0);
+    std::cout << std::endl;
+    std::cout << "width     euclid      binary      lehmer        speedup" << std::endl;
+    bench_gcd<128>(g);
+    bench_gcd<256>(g);
+    bench_gcd<512>(g);
+    bench_gcd<1024>(g);
+    bench_gcd<2048>(g);
+    bench_gcd<8192>(g);
+    std::cout << std::endl;
+    std::cout << "width     op         wide_int  scalar     avx2       avx512" << std::endl;
+    bench_array<128>(g);
+    bench_array<256>(g);
+    bench_array<1024>(g);
+    std::cout << std::endl;
+    std::cout << "bits      op      uint8192  big_int     arena       speedup" << std::endl;
+    bench_big_int<256>(g);
+    bench_big_int<1024>(g);
+    bench_big_int<4096>(g);
+}
@@ -5,6 +5,89 @@
 constexpr yao_math::uint256 foo = yao_math::pow(yao_math::uint256(3), 100);
 constexpr yao_math::uint256 bar = yao_math::uint256::from_string("515377520732011331036461129765621272702107522001");
 static_assert(foo == bar);
+static_assert(yao_math::wide_int<24, true>(-2) * yao_math::sint256(3) == yao_math::sint256(-6));
+static_assert((yao_math::uint128(1) << 100 >> 99) == yao_math::uint128(2));
+// word-granular shifts at limb boundaries and beyond the width
+static_assert((yao_math::uint256(5) << 128 >> 127) == yao_math::uint256(10));
+static_assert((yao_math::uint256(5) << 256) == yao_math::uint256(0));
+static_assert((yao_math::sint256(-5) >> 1000) == yao_math::sint256(-1));
+static_assert((yao_math::sint256(-1) << 64 >> 64) == yao_math::sint256(-1));
+static_assert((yao_math::uint256(1) << 200).countl_zero() == 55 && (yao_math::uint256(1) << 200).countr_zero() == 200);
+static_assert(yao_math::uint256(0).countl_zero() == 256 && yao_math::uint256(0).bit_width() == 0);
+static_assert(yao_math::sint256(-1).popcount() == 256 && yao_math::wide_int<24, false>(0x1234).bit_width() == 13);
+// a power of two divides by a shift, also the magnitude of the minimum
+static_assert(-(yao_math::sint128(1) << 127) / (yao_math::sint128(1) << 64) == -(yao_math::sint128(1) << 63));
+static_assert(yao_math::sint128(-77) % yao_math::sint128(8) == yao_math::sint128(-5));
+constexpr yao_math::sint512 big = -(yao_math::sint512(1) << 400) + yao_math::sint512(12345);
+constexpr yao_math::sint512 divisor = (yao_math::sint512(1) << 130) - yao_math::sint512(7);
+static_assert(big / divisor * divisor + big % divisor == big);
+static_assert(big % divisor > -divisor && big % divisor <= yao_math::sint512(0));
+// goes through the truncated Karatsuba path
+static_assert(yao_math::pow(yao_math::uint4096(3), 2000) == yao_math::pow(yao_math::pow(yao_math::uint4096(3), 1000), 2));
+// goes through the divide-and-conquer radix conversion both ways
+constexpr yao_math::uint8192 huge = yao_math::pow(yao_math::uint8192(3), 5000);
+static_assert(yao_math::uint8192::from_string(huge.to_string().c_str()) == huge);
+static_assert(yao_math::uint8192::from_string(huge.to_string(36).c_str(), 36) == huge);
+static_assert((-(yao_math::sint128(1) << 127)).to_string() == "-170141183460469231731687303715884105728");
+// consecutive Fibonacci numbers make the longest run of Lehmer steps
+constexpr yao_math::uint512 fib300 = yao_math::uint512::from_string("222232244629420445529739893461909967206666939096499764990979600");
+constexpr yao_math::uint512 fib299 = yao_math::uint512::from_string("137347080577163115432025771710279131845700275212767467264610201");
+static_assert(yao_math::gcd(fib300, fib299) == yao_math::uint512(1));
+static_assert(yao_math::gcd(fib300 * yao_math::uint512(7), -yao_math::sint512(fib299 * yao_math::uint512(7))) == yao_math::sint512(7));
+// below 64 bits a limb, the binary gcd subtracts close numbers whose top limbs cancel
+static_assert(yao_math::gcd(-yao_math::wide_int<200, true>::from_string("476289755984436467770295265908014625009046721904679291452054"),
+                            yao_math::wide_int<200, true>::from_string("29295174055024618127150847048371813")) == yao_math::wide_int<200, true>(11));
+static_assert(yao_math::gcd(yao_math::wide_int<136, false>::from_string("53314962346299468002419682305545013351536"),
+                            yao_math::wide_int<136, false>::from_string("53314962346299468002419682305544984657136")) == yao_math::wide_int<136, false>(48));
+static_assert(yao_math::lcm(yao_math::sint256(-4), yao_math::sint256(6)) == yao_math::sint256(12));
+constexpr auto bezout = yao_math::gcdext(fib300, fib299);
+static_assert(bezout.x * yao_math::sint512(fib300) + bezout.y * yao_math::sint512(fib299) == yao_math::sint512(1));
+// conversions to floating point round to nearest, ties to even
+static_assert(((yao_math::uint256(1) << 200) + (yao_math::uint256(1) << 147)).to_float<double>() == 0x1p200);
+static_assert(((yao_math::uint256(1) << 200) + (yao_math::uint256(3) << 147)).to_float<double>() == 0x1.0000000000002p200);
+static_assert(((yao_math::uint256(1) << 200) + (yao_math::uint256(1) << 147) + yao_math::uint256(1)).to_float<double>() == 0x1.0000000000001p200);
+static_assert((-(yao_math::sint128(1) << 127)).to_float<float>() == -0x1p127f && yao_math::uint128(~0ull).to_float<float>() == 0x1p64f);
+static_assert(yao_math::uint256(~0ull).to_float<long double>() == 0xFFFFFFFFFFFFFFFFp0L);
+static_assert((yao_math::uint256(1) << 255).to_float<float>() == std::numeric_limits<float>::infinity());
+#ifdef __SIZEOF_FLOAT128__
+static_assert((yao_math::pow(yao_math::uint256(3), 66)).to_float<__float128>() == __float128(yao_math::pow(yao_math::uint256(3), 33).to_float<double>()) * __float128(yao_math::pow(yao_math::uint256(3), 33).to_float<double>()));
+#endif
+static_assert(yao_math::sint256::from_float(-0x1.8p200) == -(yao_math::sint256(3) << 199));
+static_assert(yao_math::sint256::from_float(-2.75) == yao_math::sint256(-2) && yao_math::uint256::from_float(0x1p-1074) == yao_math::uint256(0));
+static_assert(yao_math::uint256::from_float(std::numeric_limits<double>::infinity()) == yao_math::uint256(0));
+static_assert(yao_math::uint256::from_float(0x1.23456789abcdep-47L * 0x1p300L) == yao_math::uint256(0x123456789abcdeull) << 201);
+static_assert(yao_math::FPBits<double>(0x1p-1074).is_subnormal() && yao_math::FPBits<long double>(-0.0L).is_zero());
+static_assert(yao_math::FPBits<double>::compose(false, yao_math::bitfield(3) << 126, -1074) == 0x1p-1073);
+
+// a generator that runs in constant expressions
+struct splitmix64 {
+    using result_type = std::uint64_t;
+    std::uint64_t state;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+    constexpr result_type operator()() {
+        std::uint64_t z = state += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// random numbers stay in range, and the generator moves on between calls
+static_assert([] {
+    splitmix64 g{42};
+    yao_math::uint256 upper = (yao_math::uint256(1) << 192) + yao_math::uint256(5);
+    yao_math::sint128 lower = -(yao_math::sint128(1) << 127), top = ~lower;
+    std::array<yao_math::wide_int<24, false>, 64> small;
+    yao_math::wide_int<24, false>::random_fill(small, g, yao_math::wide_int<24, false>(0x0102FF));
+    for (int i = 0; i < 64; ++i) {
+        if (yao_math::uint256::random(g, upper) > upper || small[i] > yao_math::wide_int<24, false>(0x0102FF)) return false;
+        auto x = yao_math::sint256::random(g, yao_math::sint256(-3), yao_math::sint256(3));
+        if (x < yao_math::sint256(-3) || x > yao_math::sint256(3)) return false;
+    }
+    return yao_math::sint128::random(g, lower, top) != yao_math::sint128::random(g, lower, top)
+        && yao_math::uint256::random(g, yao_math::uint256(0)) == yao_math::uint256(0);
+}());
 
 int main() {
     using namespace std;
@@ -13,4 +96,5 @@ int main() {
     using namespace yao_math::wide_int_literals;
     cout << hash<uint256>{}(1000000000000000000000000000000000000000000000000000000000_uL256) << endl;
     cout << toTex(bar) << endl;
+    cout << (yao_math::uint512(1) << 300).to_float<double>() << ' ' << yao_math::sint128(-12345).to_float<float>() << endl;
 }
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include <cstdint>
+#include <array>
+#include <stdexcept>
+
+#include "wide_int.cpp"
+#include "modular.cpp"
+#include "primality.cpp"
+
+#ifndef YAO_MATH_WIDE_PRIME
+#define YAO_MATH_WIDE_PRIME
+
+namespace yao_math {
+
+namespace primality {
+
+constexpr size_t SIEVE_LIMIT = 1 << 16;
+// the odd primes up to here divide the numbers before any Miller-Rabin
+constexpr size_t TRIAL_LIMIT = 1 << 10;
+
+constexpr size_t count_sieve_primes() {
+    std::array<bool, SIEVE_LIMIT> composite{};
+    size_t ret = 0;
+    for (size_t i = 3; i < SIEVE_LIMIT; i += 2) {
+        if (composite[i]) continue;
+        ++ret;
+        for (size_t j = i * i; j < SIEVE_LIMIT; j += 2 * i) composite[j] = true;
+    }
+    return ret;
+}
+
+// the odd primes below SIEVE_LIMIT, for the candidate windows of next_prime
+constexpr auto sieve_primes = [] {
+    std::array<uint32_t, count_sieve_primes()> ret{};
+    std::array<bool, SIEVE_LIMIT> composite{};
+    size_t n = 0;
+    for (size_t i = 3; i < SIEVE_LIMIT; i += 2) {
+        if (composite[i]) continue;
+        ret[n++] = uint32_t(i);
+        for (size_t j = i * i; j < SIEVE_LIMIT; j += 2 * i) composite[j] = true;
+    }
+    return ret;
+}();
+
+/*
+ * the sieve primes in runs whose product fits 64 bits, so that a wide number
+ * is reduced once per run with the reciprocal of the product, and each prime
+ * takes the remainder of the product in a single word
+ */
+struct prime_run {
+    limb::inverse<uint64_t> product{1};
+    uint32_t first = 0, last = 0;
+};
+
+constexpr size_t count_prime_runs() {
+    size_t ret = 0;
+    for (size_t i = 0; i < sieve_primes.size(); ++ret) {
+        uint64_t product = 1;
+        while (i < sieve_primes.size() && product <= UINT64_MAX / sieve_primes[i]) product *= sieve_primes[i++];
+    }
+    return ret;
+}
+
+constexpr auto prime_runs = [] {
+    std::array<prime_run, count_prime_runs()> ret{};
+    for (uint32_t i = 0, n = 0; i < sieve_primes.size(); ++n) {
+        uint64_t product = 1;
+        uint32_t first = i;
+        while (i < sieve_primes.size() && product <= UINT64_MAX / sieve_primes[i]) product *= sieve_primes[i++];
+        ret[n] = {limb::inverse<uint64_t>(product), first, i};
+    }
+    return ret;
+}();
+
+// the limbs of n gathered into 64-bit words, for the widths whose limbs are narrower
+template<size_t N>
+struct words64 {
+    uint64_t words[(N + 63) / 64] = {};
+    size_t size = 0;
+
+    constexpr explicit words64(wide_int<N, false> const& n) noexcept {
+        using T = wide_int<N, false>;
+        size_t an = n.significant_limbs();
+        for (size_t i = 0; i < an; ++i)
+            words[i * T::LIMB_BITS / 64] |= uint64_t(n.limbs[i]) << (i * T::LIMB_BITS % 64);
+        size = (an * T::LIMB_BITS + 63) / 64;
+    }
+};
+
+// the residues of n modulo the sieve primes from first on, until one of them is 0 when stop is set
+template<size_t N>
+constexpr bool sieve_residues(wide_int<N, false> const& n, uint32_t* residues, size_t limit, bool stop) noexcept {
+    words64<N> a(n);
+    for (auto const& run : prime_runs) {
+        if (run.first >= limit) break;
+        uint64_t r = a.size ? limb::mod_1(a.words, a.size, run.product) : 0;
+        for (uint32_t i = run.first; i < run.last && i < limit; ++i) {
+            residues[i] = uint32_t(r % sieve_primes[i]);
+            if (stop && !residues[i]) return false;
+        }
+    }
+    return true;
+}
+
+// whether n has no odd prime factor below limit
+template<size_t N>
+constexpr bool trial_division(wide_int<N, false> const& n, size_t limit) noexcept {
+    size_t count = 0;
+    while (count < sieve_primes.size() && sieve_primes[count] < limit) ++count;
+    uint32_t residues[sieve_primes.size()];
+    return sieve_residues(n, residues, count, true);
+}
+
+// the Jacobi symbol (a / n) of a 64-bit a and an odd n, by the binary algorithm
+constexpr int jacobi(uint64_t a, uint64_t n) noexcept {
+    int ret = 1;
+    a %= n;
+    while (a) {
+        int zeros = std::countr_zero(a);
+        a >>= zeros;
+        // (2 / n) = -1 for n = 3, 5 mod 8
+        if (zeros & 1 && (n % 8 == 3 || n % 8 == 5)) ret = -ret;
+        // quadratic reciprocity
+        if (a % 4 == 3 && n % 4 == 3) ret = -ret;
+        std::swap(a, n);
+        a %= n;
+    }
+    return n == 1 ? ret : 0;
+}
+
+// the Jacobi symbol (d / n) of a small d and a wide odd n
+template<size_t N>
+constexpr int jacobi(int64_t d, wide_int<N, false> const& n) noexcept {
+    uint64_t a = d < 0 ? uint64_t(-d) : uint64_t(d);
+    int ret = d < 0 && n.limbs[0] % 4 == 3 ? -1 : 1;
+    int zeros = std::countr_zero(a);
+    a >>= zeros;
+    if (zeros & 1 && (n.limbs[0] % 8 == 3 || n.limbs[0] % 8 == 5)) ret = -ret;
+    // (a / n) = (n mod a / a) up to the sign of reciprocity
+    if (a % 4 == 3 && n.limbs[0] % 4 == 3) ret = -ret;
+    words64<N> w(n);
+    uint64_t r = limb::mod_1(w.words, w.size, limb::inverse<uint64_t>(a));
+    return ret * jacobi(r, a);
+}
+
+// the strong probable prime test of the odd n to the base in the Montgomery form
+template<size_t N>
+constexpr bool strong_probable_prime(montgomery_context<N> const& ctx, wide_int<N, false> const& base) {
+    using T = wide_int<N, false>;
+    T minus_one = ctx.sub(T(0), ctx.one()), n1 = ctx.modulus() - T(1);
+    size_t s = n1.countr_zero();
+    T x = ctx.pow(base, n1 >> s);
+    if (x == ctx.one() || x == minus_one) return true;
+    for (size_t i = 1; i < s; ++i) {
+        x = ctx.sqr(x);
+        if (x == minus_one) return true;
+    }
+    return false;
+}
+
+/*
+ * the strong Lucas probable prime test with the parameters of Selfridge,
+ * P = 1 and Q = (1 - D) / 4 for the first D of 5, -7, 9, -11... with (D / n) = -1,
+ * the odd n is not a square, which would leave no such D
+ */
+template<size_t N>
+constexpr bool strong_lucas_probable_prime(montgomery_context<N> const& ctx) {
+    using T = wide_int<N, false>;
+    T const& n = ctx.modulus();
+    int64_t d = 5;
+    for (;; d = d > 0 ? -d - 2 : -d + 2) {
+        int j = jacobi(d, n);
+        if (j == -1) break;
+        // a common factor, unless n is d itself
+        if (j == 0 && T(uint64_t(d < 0 ? -d : d)) != n) return false;
+    }
+    auto residue = [&](int64_t x) {
+        return ctx.to_montgomery(x < 0 ? n - T(uint64_t(-x)) : T(uint64_t(x)));
+    };
+    T D = residue(d), Q = residue((1 - d) / 4);
+    // x / 2 mod n, where (x + n) / 2 does not overflow for odd x and n
+    auto half = [&](T const& x) {
+        return x.limbs[0] & 1 ? (x >> 1) + (n >> 1) + T(1) : x >> 1;
+    };
+    T n1 = n + T(1);
+    size_t s = n1.countr_zero();
+    T k = n1 >> s;
+    // U_1 = 1, V_1 = P = 1, going through the bits of k from the top
+    T U = ctx.one(), V = ctx.one(), Qk = Q;
+    for (size_t i = k.log2(); i--;) {
+        // U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+        U = ctx.mul(U, V);
+        V = ctx.sub(ctx.sqr(V), ctx.add(Qk, Qk));
+        Qk = ctx.sqr(Qk);
+        if (k.limbs[i / T::LIMB_BITS] >> (i % T::LIMB_BITS) & 1) {
+            // U_k+1 = (P U_k + V_k) / 2, V_k+1 = (D U_k + P V_k) / 2
+            T u = half(ctx.add(U, V));
+            V = half(ctx.add(ctx.mul(D, U), V));
+            U = u;
+            Qk = ctx.mul(Qk, Q);
+        }
+    }
+    if (!U || !V) return true;
+    for (size_t r = 1; r < s; ++r) {
+        V = ctx.sub(ctx.sqr(V), ctx.add(Qk, Qk));
+        if (!V) return true;
+        Qk = ctx.sqr(Qk);
+    }
+    return false;
+}
+
+enum class verdict_t { composite, prime, unknown };
+
+// settles the numbers of 64 bits, and those with a small factor
+template<size_t N>
+constexpr verdict_t wide_prefilter(wide_int<N, false> const& n) noexcept {
+    if (n.bit_width() <= 64) return is_prime(n.template to_integral<uint64_t>()) ? verdict_t::prime : verdict_t::composite;
+    if (!(n.limbs[0] & 1) || !trial_division(n, TRIAL_LIMIT)) return verdict_t::composite;
+    return verdict_t::unknown;
+}
+
+}
+
+/*
+ * the Baillie-PSW test: trial division, a strong probable prime test to the
+ * base 2 and a strong Lucas probable prime test, with no known counterexample,
+ * and exact below 2^64
+ */
+template<size_t N>
+constexpr bool is_probable_prime(wide_int<N, false> const& n) {
+    using namespace primality;
+    using T = wide_int<N, false>;
+    if (verdict_t v = wide_prefilter(n); v != verdict_t::unknown) return v == verdict_t::prime;
+    montgomery_context<N> ctx(n);
+    if (!strong_probable_prime(ctx, ctx.to_montgomery(T(2)))) return false;
+    T root = isqrt(n);
+    if (root * root == n) return false;
+    return strong_lucas_probable_prime(ctx);
+}
+
+// the Miller-Rabin test to the given number of random bases in [2, n - 2], each missing a composite with a chance below 1/4
+template<size_t N, typename G>
+constexpr bool miller_rabin(wide_int<N, false> const& n, size_t rounds, G& g) {
+    using namespace primality;
+    using T = wide_int<N, false>;
+    if (verdict_t v = wide_prefilter(n); v != verdict_t::unknown) return v == verdict_t::prime;
+    montgomery_context<N> ctx(n);
+    for (size_t i = 0; i < rounds; ++i) {
+        if (!strong_probable_prime(ctx, ctx.to_montgomery(T::random(g, T(2), n - T(2))))) return false;
+    }
+    return true;
+}
+
+// the Baillie-PSW test followed by rounds of Miller-Rabin to random bases
+template<size_t N, typename G>
+constexpr bool is_probable_prime(wide_int<N, false> const& n, size_t rounds, G& g) {
+    return is_probable_prime(n) && miller_rabin(n, rounds, g);
+}
+
+/*
+ * the least probable prime above n, the odd candidates being sieved by
+ * the primes below 2^16 a window at a time, so that only the survivors
+ * go through Baillie-PSW
+ */
+template<size_t N>
+constexpr wide_int<N, false> next_prime(wide_int<N, false> const& n) {
+    using namespace primality;
+    using T = wide_int<N, false>;
+    constexpr uint32_t WINDOW = 4096;
+    // the small primes themselves would be sieved out
+    if (n.bit_width() < 32) {
+        for (uint64_t m = n.template to_integral<uint64_t>() + 1;; ++m) {
+            if (!is_prime(m)) continue;
+            if (size_t(std::bit_width(m)) > N) throw std::overflow_error("no prime above in the width");
+            return T(m);
+        }
+    }
+    T start = n + T(n.limbs[0] & 1 ? 2 : 1);
+    if (start <= n) throw std::overflow_error("no prime above in the width");
+    std::array<uint32_t, sieve_primes.size()> residues{};
+    sieve_residues(start, residues.data(), residues.size(), false);
+    while (true) {
+        // the candidate start + 2i is divisible by p for i = -r / 2 mod p
+        std::array<bool, WINDOW> composite{};
+        for (size_t j = 0; j < sieve_primes.size(); ++j) {
+            uint32_t p = sieve_primes[j], r = residues[j];
+            for (uint64_t i = r ? uint64_t(p - r) * ((p + 1) / 2) % p : 0; i < WINDOW; i += p) composite[i] = true;
+            residues[j] = uint32_t((r + 2 * WINDOW) % p);
+        }
+        for (uint32_t i = 0; i < WINDOW; ++i) {
+            if (composite[i]) continue;
+            T candidate = start + T(2 * i);
+            if (candidate < start) throw std::overflow_error("no prime above in the width");
+            if (is_probable_prime(candidate)) return candidate;
+        }
+        T next = start + T(2 * WINDOW);
+        if (next < start) throw std::overflow_error("no prime above in the width");
+        start = next;
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+#include "wide_prime.cpp"
+
+#include <iostream>
+#include <random>
+
+// the smallest strong Lucas pseudoprimes with the parameters of Selfridge pass the Lucas part alone
+static_assert(yao_math::primality::strong_lucas_probable_prime(yao_math::montgomery_context<128>(yao_math::uint128(5459))));
+static_assert(yao_math::primality::strong_lucas_probable_prime(yao_math::montgomery_context<128>(yao_math::uint128(5777))));
+static_assert(!yao_math::primality::strong_lucas_probable_prime(yao_math::montgomery_context<128>(yao_math::uint128(5461))));
+// the Mersenne numbers 2^p - 1
+static_assert(yao_math::is_probable_prime((yao_math::uint128(1) << 127) - yao_math::uint128(1)));
+static_assert(!yao_math::is_probable_prime((yao_math::uint256(1) << 67) - yao_math::uint256(1)));
+static_assert(!yao_math::is_probable_prime(((yao_math::uint256(1) << 89) - yao_math::uint256(1)) * ((yao_math::uint256(1) << 89) - yao_math::uint256(1))));
+// 2^64 + 13 is the first prime past 64 bits
+static_assert(yao_math::next_prime(yao_math::uint128(18446744073709551557u)) == (yao_math::uint128(1) << 64) + yao_math::uint128(13));
+static_assert(yao_math::isqrt((yao_math::uint256(1) << 200) - yao_math::uint256(1)) == (yao_math::uint256(1) << 100) - yao_math::uint256(1));
+// 24 bits go by the 64-bit shortcut, which stops at the top of the width
+static_assert(yao_math::next_prime(yao_math::wide_int<24, false>(16777200)) == yao_math::wide_int<24, false>(16777213));
+
+int main() {
+    using namespace std;
+    using namespace yao_math;
+    // the 512-bit primes above 2^511, each confirmed by 20 more random bases
+    mt19937_64 g(512);
+    uint512 p = uint512(1) << 511;
+    int ret = 0;
+    for (int i = 0; i < 3; ++i) {
+        p = next_prime(p);
+        if (!miller_rabin(p, 20, g)) ret = 1;
+        cout << "2^511 + " << p - (uint512(1) << 511) << endl;
+    }
+    // 200 bits go by 8-bit limbs, too many steps for a constant expression
+    using uint200 = wide_int<200, false>;
+    if (!is_probable_prime((uint200(1) << 127) - uint200(1)) || is_probable_prime((uint200(1) << 67) - uint200(1))) ret = 1;
+    if (next_prime(uint200(18446744073709551557u)) != (uint200(1) << 64) + uint200(13)) ret = 1;
+    if (next_prime(uint200(1) << 150).bit_width() != 151 || !miller_rabin(next_prime(uint200(1) << 150), 20, g)) ret = 1;
+    try {
+        next_prime(wide_int<24, false>(16777213));
+        ret = 1;
+    } catch (overflow_error const&) {}
+    return ret;
+}
@@ -19,7 +19,7 @@ std::string toTex(T t) {
 // generic implementation of fast power with the integral exponent
 template<typename Base>
 constexpr Base pow(Base a, size_t n) {
-	Base r = 1;
+	Base r(1);
 	// while(n & 1 && (r *= a, 0), n && (a *= a, 0), n >>= 1);
 	do {
 		if (n & 1) r *= a;